@@ -0,0 +1,308 @@
+/*!
+ * \file BallTracker.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <string>
+
+#include "BallTracker.hpp"
+#include "Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+namespace {
+
+/*!
+ * Sets noise covariances of constant-velocity model with state [x y vx vy].
+ * Acceleration is white noise, so Q = G * G^T * sigma_a^2, G = [1/2 1]^T per axis.
+ */
+void setNoise(cv::KalmanFilter& kf, double process_noise, double measurement_noise)
+{
+    float qa = process_noise * process_noise;
+    kf.processNoiseCov = (cv::Mat_<float>(4, 4) <<
+            0.25f * qa, 0, 0.5f * qa, 0,
+            0, 0.25f * qa, 0, 0.5f * qa,
+            0.5f * qa, 0, qa, 0,
+            0, 0.5f * qa, 0, qa);
+    cv::setIdentity(kf.measurementNoiseCov, cv::Scalar::all(measurement_noise * measurement_noise));
+}
+
+}
+
+BallTracker::BallTracker(const std::string & name) : Base::Component(name),
+    m_has_measurement(false),
+    m_process_noise("process_noise", 2.0, "range"),
+    m_measurement_noise("measurement_noise", 3.0, "range"),
+    m_gate_sigma("gate_sigma", 3.0, "range"),
+    m_max_misses("max_misses", 5, "range"),
+    m_max_tracks("max_tracks", 4, "range")
+{
+    m_process_noise.addConstraint("0.01");
+    m_process_noise.addConstraint("100.0");
+    registerProperty(m_process_noise);
+
+    m_measurement_noise.addConstraint("0.01");
+    m_measurement_noise.addConstraint("100.0");
+    registerProperty(m_measurement_noise);
+
+    m_gate_sigma.addConstraint("1.0");
+    m_gate_sigma.addConstraint("10.0");
+    registerProperty(m_gate_sigma);
+
+    m_max_misses.addConstraint("0");
+    m_max_misses.addConstraint("1000");
+    registerProperty(m_max_misses);
+
+    m_max_tracks.addConstraint("1");
+    m_max_tracks.addConstraint("32");
+    registerProperty(m_max_tracks);
+
+    LOG(LTRACE) << "Hello BallTracker\n";
+}
+
+BallTracker::~BallTracker()
+{
+    LOG(LTRACE) << "Good bye BallTracker\n";
+}
+
+void BallTracker::prepareInterface()
+{
+
+    LOG(LTRACE) << "BallTracker::initialize\n";
+
+    h_onNewPosition.setup(this, &BallTracker::onNewPosition);
+    registerHandler("onNewPosition", &h_onNewPosition);
+
+    h_onPredict.setup(this, &BallTracker::onPredict);
+    registerHandler("onPredict", &h_onPredict);
+
+    registerStream("in_imagePosition", &in_imagePosition);
+    addDependency("onNewPosition", &in_imagePosition);
+
+    // prediction runs every step, camera info is read when available
+    registerStream("in_cameraInfo", &in_cameraInfo);
+    addDependency("onPredict", NULL);
+
+    registerStream("out_prediction", &out_prediction);
+    registerStream("out_covariance", &out_covariance);
+    registerStream("out_roi", &out_roi);
+
+}
+
+bool BallTracker::onInit()
+{
+    return true;
+}
+
+bool BallTracker::onFinish()
+{
+    LOG(LTRACE) << "BallTracker::finish\n";
+
+    return true;
+}
+
+bool BallTracker::onStep()
+{
+    LOG(LTRACE) << "BallTracker::step\n";
+    return true;
+}
+
+bool BallTracker::onStop()
+{
+    return true;
+}
+
+bool BallTracker::onStart()
+{
+    m_tracks.clear();
+    m_has_measurement = false;
+    return true;
+}
+
+void BallTracker::onNewPosition()
+{
+    LOG(LTRACE) << "BallTracker::onNewPosition\n";
+
+    m_measurement = in_imagePosition.read();
+    m_has_measurement = true;
+}
+
+void BallTracker::startTrack(const cv::Mat& z, float size, float ratio)
+{
+    Track track;
+    track.kf.init(4, 2, 0, CV_32F);
+    track.kf.transitionMatrix = (cv::Mat_<float>(4, 4) <<
+            1, 0, 1, 0,
+            0, 1, 0, 1,
+            0, 0, 1, 0,
+            0, 0, 0, 1);
+    cv::setIdentity(track.kf.measurementMatrix);
+    setNoise(track.kf, m_process_noise, m_measurement_noise);
+
+    track.kf.statePost.at<float>(0) = z.at<float>(0);
+    track.kf.statePost.at<float>(1) = z.at<float>(1);
+
+    // velocity is unknown, let it be anything up to the ball size per step
+    float pos_var = m_measurement_noise * m_measurement_noise;
+    float vel_var = std::max(1.0f, size * size);
+    track.kf.errorCovPost = (cv::Mat_<float>(4, 4) <<
+            pos_var, 0, 0, 0,
+            0, pos_var, 0, 0,
+            0, 0, vel_var, 0,
+            0, 0, 0, vel_var);
+
+    track.size = size;
+    track.ratio = ratio;
+    track.hits = 1;
+    track.misses = 0;
+
+    if ((int) m_tracks.size() < m_max_tracks) {
+        m_tracks.push_back(track);
+        return;
+    }
+
+    // replace the track which was missing for the longest time
+    size_t worst = 0;
+    for (size_t i = 1; i < m_tracks.size(); ++i) {
+        if (m_tracks[i].misses > m_tracks[worst].misses
+                || (m_tracks[i].misses == m_tracks[worst].misses && m_tracks[i].hits < m_tracks[worst].hits))
+            worst = i;
+    }
+    m_tracks[worst] = track;
+}
+
+int BallTracker::associate(const cv::Mat& z)
+{
+    double gate = m_gate_sigma * m_gate_sigma;
+    double best_d2 = gate;
+    int best = -1;
+
+    for (size_t i = 0; i < m_tracks.size(); ++i) {
+        const cv::KalmanFilter& kf = m_tracks[i].kf;
+
+        // squared Mahalanobis distance of the innovation
+        cv::Mat S = kf.measurementMatrix * kf.errorCovPost * kf.measurementMatrix.t() + kf.measurementNoiseCov;
+        cv::Mat y = z - kf.measurementMatrix * kf.statePost;
+        double d2 = cv::Mat(y.t() * S.inv() * y).at<float>(0);
+
+        if (d2 <= best_d2) {
+            best_d2 = d2;
+            best = i;
+        }
+    }
+    return best;
+}
+
+void BallTracker::publish()
+{
+    if (m_tracks.empty()) {
+        // nothing to follow - search whole image
+        out_roi.write(cv::Rect());
+        return;
+    }
+
+    // the track observed most often is taken as the ball
+    size_t best = 0;
+    for (size_t i = 1; i < m_tracks.size(); ++i) {
+        if (m_tracks[i].hits > m_tracks[best].hits
+                || (m_tracks[i].hits == m_tracks[best].hits && m_tracks[i].misses < m_tracks[best].misses))
+            best = i;
+    }
+    const Track& track = m_tracks[best];
+    const cv::KalmanFilter& kf = track.kf;
+
+    // state and covariance one step ahead
+    cv::Mat state = kf.transitionMatrix * kf.statePost;
+    cv::Mat cov = kf.transitionMatrix * kf.errorCovPost * kf.transitionMatrix.t() + kf.processNoiseCov;
+
+    float x = state.at<float>(0);
+    float y = state.at<float>(1);
+
+    double maxPixels = std::max(m_camera.width, m_camera.height);
+    Types::ImagePosition prediction;
+    prediction.elements[0] = (x - m_camera.width / 2) / maxPixels;
+    prediction.elements[1] = (y - m_camera.height / 2) / maxPixels;
+    prediction.elements[2] = track.size / maxPixels;
+    prediction.elements[3] = track.ratio;
+    out_prediction.write(prediction);
+
+    out_covariance.write(cov(cv::Rect(0, 0, 2, 2)).clone());
+
+    float half_w = m_gate_sigma * std::sqrt(cov.at<float>(0, 0)) + track.size / 2;
+    float half_h = m_gate_sigma * std::sqrt(cov.at<float>(1, 1)) + track.size / 2;
+    out_roi.write(cv::Rect(cvFloor(x - half_w), cvFloor(y - half_h), cvCeil(2 * half_w), cvCeil(2 * half_h)));
+}
+
+void BallTracker::onPredict()
+{
+    LOG(LTRACE) << "BallTracker::onPredict\n";
+    try {
+        if (in_cameraInfo.fresh())
+            m_camera = in_cameraInfo.read();
+
+        if (m_camera.width <= 0 || m_camera.height <= 0) {
+            m_has_measurement = false;
+            return;
+        }
+
+        for (size_t i = 0; i < m_tracks.size(); ++i) {
+            setNoise(m_tracks[i].kf, m_process_noise, m_measurement_noise);
+            m_tracks[i].kf.predict();
+            ++m_tracks[i].misses;
+        }
+
+        if (m_has_measurement) {
+            m_has_measurement = false;
+
+            // back from (-1, 1) coordinates of FeatureExtraction to pixels
+            double maxPixels = std::max(m_camera.width, m_camera.height);
+            cv::Mat z = (cv::Mat_<float>(2, 1) <<
+                    m_measurement.elements[0] * maxPixels + m_camera.width / 2,
+                    m_measurement.elements[1] * maxPixels + m_camera.height / 2);
+            float size = m_measurement.elements[2] * maxPixels;
+            float ratio = m_measurement.elements[3];
+
+            int i = associate(z);
+            if (i >= 0) {
+                Track& track = m_tracks[i];
+                track.kf.correct(z);
+                track.size = size;
+                track.ratio = ratio;
+                ++track.hits;
+                track.misses = 0;
+            } else {
+                startTrack(z, size, ratio);
+            }
+        }
+
+        for (size_t i = 0; i < m_tracks.size();) {
+            if (m_tracks[i].misses > m_max_misses)
+                m_tracks.erase(m_tracks.begin() + i);
+            else
+                ++i;
+        }
+
+        publish();
+
+    }
+    catch (Common::DisCODeException& ex) {
+        LOG(LERROR) << ex.what() << "\n";
+        ex.printStackTrace();
+        exit(EXIT_FAILURE);
+    }
+    catch (const char * ex) {
+        LOG(LERROR) << ex;
+    }
+    catch (...) {
+        LOG(LERROR) << "BallTracker::onPredict failed\n";
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Processors
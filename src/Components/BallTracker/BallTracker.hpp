@@ -0,0 +1,165 @@
+/*!
+ * \file BallTracker.hpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BALL_TRACKER_HPP_
+#define BALL_TRACKER_HPP_
+
+#include "Component_Aux.hpp"
+#include "Component.hpp"
+#include "DataStream.hpp"
+
+#include "Property.hpp"
+
+#include <vector>
+
+#include <opencv2/opencv.hpp>
+
+#include "Types/ImagePosition.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class BallTracker
+ * \brief Tracks ball positions with constant-velocity Kalman filters.
+ *
+ * Filters advance once per executor step, positions from
+ * FeatureExtraction correct the track they fall into (within gate_sigma
+ * standard deviations), other positions start new tracks. Prediction
+ * of the longest track is published every step, also when detection
+ * runs at a lower rate, so upstream components can search only the
+ * predicted window.
+ */
+class BallTracker: public Base::Component
+{
+public:
+    /*!
+     * Constructor.
+     */
+    BallTracker(const std::string & name = "");
+
+    /*!
+     * Destructor
+     */
+    virtual ~BallTracker();
+
+
+    void prepareInterface();
+
+protected:
+
+    /*!
+     * Connects source to given device.
+     */
+    bool onInit();
+
+    /*!
+     * Disconnect source from device, closes streams, etc.
+     */
+    bool onFinish();
+
+    /*!
+     * Retrieves data from device.
+     */
+    bool onStep();
+
+    /*!
+     * Start component
+     */
+    bool onStart();
+
+    /*!
+     * Stop component
+     */
+    bool onStop();
+
+
+    /*!
+     * Stores measured position until the next step.
+     */
+    void onNewPosition();
+
+    /*!
+     * Advances all tracks by one step and publishes prediction.
+     */
+    void onPredict();
+
+    /// Event handlers.
+    Base::EventHandler <BallTracker> h_onNewPosition;
+    Base::EventHandler <BallTracker> h_onPredict;
+
+    /// Input data stream - measured ball position (FeatureExtraction out_imagePosition)
+    Base::DataStreamIn <Types::ImagePosition> in_imagePosition;
+
+    /// Input data stream containing camera properties.
+    Base::DataStreamIn <cv::Size> in_cameraInfo;
+
+    /// Predicted ball position for the next step, in the same coordinates as in_imagePosition
+    Base::DataStreamOut <Types::ImagePosition> out_prediction;
+
+    /// Covariance of predicted position, 2x2 CV_32F, in pixels^2
+    Base::DataStreamOut <cv::Mat> out_covariance;
+
+    /// Gate around predicted position, empty when nothing is tracked
+    Base::DataStreamOut <cv::Rect> out_roi;
+
+private:
+    struct Track
+    {
+        cv::KalmanFilter kf;
+
+        /// Ball diameter and ellipse factor from the last measurement.
+        float size;
+        float ratio;
+
+        int hits;
+        int misses;
+    };
+
+    /// Creates track starting at \p z, in pixels.
+    void startTrack(const cv::Mat& z, float size, float ratio);
+
+    /// Index of track nearest to \p z within the gate, -1 if there is none.
+    int associate(const cv::Mat& z);
+
+    /// Publishes prediction of the best track.
+    void publish();
+
+    std::vector<Track> m_tracks;
+
+    /// Last measurement, waiting for the next step.
+    Types::ImagePosition m_measurement;
+    bool m_has_measurement;
+
+    cv::Size m_camera;
+
+    /// Standard deviation of acceleration, in pixels per step^2.
+    Base::Property<double> m_process_noise;
+
+    /// Standard deviation of measured position, in pixels.
+    Base::Property<double> m_measurement_noise;
+
+    /// Gate size in standard deviations.
+    Base::Property<double> m_gate_sigma;
+
+    /// Number of steps without measurement after which track is dropped.
+    Base::Property<int> m_max_misses;
+
+    /// Maximal number of tracks kept at once.
+    Base::Property<int> m_max_tracks;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+
+/*
+ * Register processor component.
+ */
+REGISTER_COMPONENT("BallTracker", Processors::Blueball::BallTracker)
+
+#endif /* BALL_TRACKER_HPP_ */
@@ -0,0 +1,110 @@
+/*!
+ * \file BitBlobExtractor.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <memory>
+#include <string>
+
+#include "BitBlobExtractor.hpp"
+#include "Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+using Types::Blueball::BitMask;
+
+BitBlobExtractor::BitBlobExtractor(const std::string & name) : Base::Component(name),
+    m_min_size("min_size", 0, "range")
+{
+    m_min_size.addConstraint("0");
+    m_min_size.addConstraint("1000000");
+    registerProperty(m_min_size);
+
+    LOG(LTRACE) << "Hello BitBlobExtractor\n";
+}
+
+BitBlobExtractor::~BitBlobExtractor()
+{
+    LOG(LTRACE) << "Good bye BitBlobExtractor\n";
+}
+
+void BitBlobExtractor::prepareInterface()
+{
+
+    LOG(LTRACE) << "BitBlobExtractor::initialize\n";
+
+    h_onNewImage.setup(this, &BitBlobExtractor::onNewImage);
+    registerHandler("onNewImage", &h_onNewImage);
+
+    registerStream("in_img", &in_img);
+    addDependency("onNewImage", &in_img);
+
+    registerStream("out_blobs", &out_blobs);
+
+}
+
+bool BitBlobExtractor::onInit()
+{
+    return true;
+}
+
+bool BitBlobExtractor::onFinish()
+{
+    LOG(LTRACE) << "BitBlobExtractor::finish\n";
+
+    return true;
+}
+
+bool BitBlobExtractor::onStep()
+{
+    LOG(LTRACE) << "BitBlobExtractor::step\n";
+    return true;
+}
+
+bool BitBlobExtractor::onStop()
+{
+    return true;
+}
+
+bool BitBlobExtractor::onStart()
+{
+    return true;
+}
+
+void BitBlobExtractor::onNewImage()
+{
+    LOG(LTRACE) << "BitBlobExtractor::onNewImage\n";
+    try {
+        BitMask mask = in_img.read();
+
+        m_labeler.reset();
+        for (int y = 0; y < mask.height(); ++y) {
+            m_runs.clear();
+            Types::Blueball::extractRuns(mask.row(y), mask.width(), m_runs);
+            m_labeler.addRow(y, m_runs.empty() ? NULL : &m_runs[0], m_runs.size());
+        }
+
+        Types::Blueball::SharedPool<Types::Blueball::RunBlobs>::Pointer blobs = m_blob_pool.get();
+        m_labeler.finish(*blobs, m_min_size);
+
+        out_blobs.write(blobs);
+
+    }
+    catch (Common::DisCODeException& ex) {
+        LOG(LERROR) << ex.what() << "\n";
+        ex.printStackTrace();
+        exit(EXIT_FAILURE);
+    }
+    catch (const char * ex) {
+        LOG(LERROR) << ex;
+    }
+    catch (...) {
+        LOG(LERROR) << "BitBlobExtractor::onNewImage failed\n";
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Processors
@@ -0,0 +1,114 @@
+/*!
+ * \file BitBlobExtractor.hpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BIT_BLOB_EXTRACTOR_HPP_
+#define BIT_BLOB_EXTRACTOR_HPP_
+
+#include "Component_Aux.hpp"
+#include "Component.hpp"
+#include "DataStream.hpp"
+
+#include "Property.hpp"
+
+#include <opencv2/opencv.hpp>
+
+#include "Types/BitMask.hpp"
+#include "Types/Runs.hpp"
+#include "Types/SharedPool.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class BitBlobExtractor
+ * \brief Finds 8-connected blobs in bit-packed masks.
+ *
+ * Runs of foreground pixels are found in each 64-pixel word with
+ * bit scans and labeled with union-find, blobs are described by
+ * their raw moments and bounding boxes.
+ */
+class BitBlobExtractor: public Base::Component
+{
+public:
+    /*!
+     * Constructor.
+     */
+    BitBlobExtractor(const std::string & name = "");
+
+    /*!
+     * Destructor
+     */
+    virtual ~BitBlobExtractor();
+
+
+    void prepareInterface();
+
+protected:
+
+    /*!
+     * Connects source to given device.
+     */
+    bool onInit();
+
+    /*!
+     * Disconnect source from device, closes streams, etc.
+     */
+    bool onFinish();
+
+    /*!
+     * Retrieves data from device.
+     */
+    bool onStep();
+
+    /*!
+     * Start component
+     */
+    bool onStart();
+
+    /*!
+     * Stop component
+     */
+    bool onStop();
+
+
+    /*!
+     * Event handler function.
+     */
+    void onNewImage();
+
+    /// Event handler.
+    Base::EventHandler <BitBlobExtractor> h_onNewImage;
+
+    /// Input mask
+    Base::DataStreamIn <Types::Blueball::BitMask> in_img;
+
+    /// Output data stream - blobs, the largest first
+    Base::DataStreamOut <Types::Blueball::SharedRunBlobs> out_blobs;
+
+private:
+    Types::Blueball::RunLabeler m_labeler;
+
+    /// Output blob lists, recycled once readers drop them.
+    Types::Blueball::SharedPool<Types::Blueball::RunBlobs> m_blob_pool;
+
+    /// Runs of the current row.
+    std::vector<Types::Blueball::Run> m_runs;
+
+    /// Minimal blob area, in pixels.
+    Base::Property<int> m_min_size;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+
+/*
+ * Register processor component.
+ */
+REGISTER_COMPONENT("BitBlobExtractor", Processors::Blueball::BitBlobExtractor)
+
+#endif /* BIT_BLOB_EXTRACTOR_HPP_ */
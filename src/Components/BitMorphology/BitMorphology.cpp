@@ -0,0 +1,121 @@
+/*!
+ * \file BitMorphology.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <memory>
+#include <string>
+
+#include "BitMorphology.hpp"
+#include "Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+using Types::Blueball::BitMask;
+
+BitMorphology::BitMorphology(const std::string & name) : Base::Component(name),
+    m_type("type", std::string("MORPH_CLOSE"), "combo"),
+    m_iterations("iterations", 1, "range")
+{
+    m_type.addConstraint("MORPH_ERODE");
+    m_type.addConstraint("MORPH_DILATE");
+    m_type.addConstraint("MORPH_OPEN");
+    m_type.addConstraint("MORPH_CLOSE");
+    registerProperty(m_type);
+
+    m_iterations.addConstraint("0");
+    m_iterations.addConstraint("20");
+    registerProperty(m_iterations);
+
+    LOG(LTRACE) << "Hello BitMorphology\n";
+}
+
+BitMorphology::~BitMorphology()
+{
+    LOG(LTRACE) << "Good bye BitMorphology\n";
+}
+
+void BitMorphology::prepareInterface()
+{
+
+    LOG(LTRACE) << "BitMorphology::initialize\n";
+
+    h_onNewImage.setup(this, &BitMorphology::onNewImage);
+    registerHandler("onNewImage", &h_onNewImage);
+
+    registerStream("in_img", &in_img);
+    addDependency("onNewImage", &in_img);
+
+    registerStream("out_img", &out_img);
+
+}
+
+bool BitMorphology::onInit()
+{
+    return true;
+}
+
+bool BitMorphology::onFinish()
+{
+    LOG(LTRACE) << "BitMorphology::finish\n";
+
+    return true;
+}
+
+bool BitMorphology::onStep()
+{
+    LOG(LTRACE) << "BitMorphology::step\n";
+    return true;
+}
+
+bool BitMorphology::onStop()
+{
+    return true;
+}
+
+bool BitMorphology::onStart()
+{
+    return true;
+}
+
+void BitMorphology::onNewImage()
+{
+    LOG(LTRACE) << "BitMorphology::onNewImage\n";
+    try {
+        BitMask src = in_img.read();
+
+        BitMask dst;
+        dst.assign(m_pool.get(BitMask::bufferSize(src.size()), CV_8UC1), src.width());
+
+        std::string type = m_type;
+        int iterations = m_iterations;
+        if (type == "MORPH_ERODE")
+            Types::Blueball::erode(src, dst, iterations);
+        else if (type == "MORPH_DILATE")
+            Types::Blueball::dilate(src, dst, iterations);
+        else if (type == "MORPH_OPEN")
+            Types::Blueball::open(src, dst, m_tmp, iterations);
+        else
+            Types::Blueball::close(src, dst, m_tmp, iterations);
+
+        out_img.write(dst);
+
+    }
+    catch (Common::DisCODeException& ex) {
+        LOG(LERROR) << ex.what() << "\n";
+        ex.printStackTrace();
+        exit(EXIT_FAILURE);
+    }
+    catch (const char * ex) {
+        LOG(LERROR) << ex;
+    }
+    catch (...) {
+        LOG(LERROR) << "BitMorphology::onNewImage failed\n";
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Processors
@@ -0,0 +1,112 @@
+/*!
+ * \file BitMorphology.hpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BIT_MORPHOLOGY_HPP_
+#define BIT_MORPHOLOGY_HPP_
+
+#include "Component_Aux.hpp"
+#include "Component.hpp"
+#include "DataStream.hpp"
+
+#include "Property.hpp"
+
+#include <opencv2/opencv.hpp>
+
+#include "Types/BitMask.hpp"
+#include "Types/MatPool.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class BitMorphology
+ * \brief Morphological operations on bit-packed masks.
+ *
+ * Counterpart of CvBasic:CvMorphology (with default 3x3 kernel) working
+ * on masks produced by LUT out_packed, 64 pixels per machine word.
+ */
+class BitMorphology: public Base::Component
+{
+public:
+    /*!
+     * Constructor.
+     */
+    BitMorphology(const std::string & name = "");
+
+    /*!
+     * Destructor
+     */
+    virtual ~BitMorphology();
+
+
+    void prepareInterface();
+
+protected:
+
+    /*!
+     * Connects source to given device.
+     */
+    bool onInit();
+
+    /*!
+     * Disconnect source from device, closes streams, etc.
+     */
+    bool onFinish();
+
+    /*!
+     * Retrieves data from device.
+     */
+    bool onStep();
+
+    /*!
+     * Start component
+     */
+    bool onStart();
+
+    /*!
+     * Stop component
+     */
+    bool onStop();
+
+
+    /*!
+     * Event handler function.
+     */
+    void onNewImage();
+
+    /// Event handler.
+    Base::EventHandler <BitMorphology> h_onNewImage;
+
+    /// Input mask
+    Base::DataStreamIn <Types::Blueball::BitMask> in_img;
+
+    /// Output mask
+    Base::DataStreamOut <Types::Blueball::BitMask> out_img;
+
+private:
+    /// Output buffers, recycled once downstream components release them.
+    Types::Blueball::MatPool m_pool;
+
+    /// Intermediate result of opening/closing.
+    Types::Blueball::BitMask m_tmp;
+
+    /// Operation: MORPH_ERODE, MORPH_DILATE, MORPH_OPEN or MORPH_CLOSE.
+    Base::Property<std::string> m_type;
+
+    Base::Property<int> m_iterations;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+
+/*
+ * Register processor component.
+ */
+REGISTER_COMPONENT("BitMorphology", Processors::Blueball::BitMorphology)
+
+#endif /* BIT_MORPHOLOGY_HPP_ */
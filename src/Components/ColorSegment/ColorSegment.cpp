@@ -0,0 +1,227 @@
+/*!
+ * \file ColorSegment.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+#include "ColorSegment.hpp"
+#include "Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+// OpenCV writes hue in range 0..180 instead of 0..360
+#define H(x) (x>>1)
+
+ColorSegment::ColorSegment(const std::string & name) : Base::Component(name),
+    m_hue_threshold_1("hue_thr_1", 180, "range"),
+    m_hue_threshold_2("hue_thr_2", 240, "range"),
+    m_sat_threshold_1("sat_thr_1", 100, "range"),
+    m_val_threshold_1("val_thr_1", 100, "range"),
+    m_kernel("kernel", std::string("auto"), "combo"),
+    m_extra_regions("extra_regions", std::string("")),
+    m_strip_bytes("strip_bytes", 32768, "range"),
+    m_buffers("buffers", 3, "range"),
+    m_produce_hue("produce_hue", false),
+    m_produce_runs("produce_runs", false),
+    m_coarse_scale("coarse_scale", 1, "range"),
+    m_coarse_margin("coarse_margin", 16, "range"),
+    m_coarse_min_area("coarse_min_area", 2, "range"),
+    m_coarse_max_regions("coarse_max_regions", 8, "range")
+{
+    m_hue_threshold_1.addConstraint("0");
+    m_hue_threshold_1.addConstraint("360");
+
+    m_hue_threshold_2.addConstraint("0");
+    m_hue_threshold_2.addConstraint("360");
+
+    m_sat_threshold_1.addConstraint("0");
+    m_sat_threshold_1.addConstraint("255");
+
+    m_val_threshold_1.addConstraint("0");
+    m_val_threshold_1.addConstraint("255");
+
+    m_strip_bytes.addConstraint("1024");
+    m_strip_bytes.addConstraint("1048576");
+
+    registerProperty(m_hue_threshold_1);
+    registerProperty(m_hue_threshold_2);
+    registerProperty(m_sat_threshold_1);
+    registerProperty(m_val_threshold_1);
+
+    m_kernel.addConstraint("auto");
+    m_kernel.addConstraint("scalar");
+    m_kernel.addConstraint("sse4");
+    m_kernel.addConstraint("avx2");
+    m_kernel.addConstraint("table");
+    registerProperty(m_kernel);
+    registerProperty(m_extra_regions);
+    registerProperty(m_strip_bytes);
+
+    m_buffers.addConstraint("1");
+    m_buffers.addConstraint("16");
+    registerProperty(m_buffers);
+    registerProperty(m_produce_hue);
+    registerProperty(m_produce_runs);
+
+    m_coarse_scale.addConstraint("1");
+    m_coarse_scale.addConstraint("16");
+    registerProperty(m_coarse_scale);
+
+    m_coarse_margin.addConstraint("0");
+    m_coarse_margin.addConstraint("512");
+    registerProperty(m_coarse_margin);
+
+    m_coarse_min_area.addConstraint("1");
+    m_coarse_min_area.addConstraint("100000");
+    registerProperty(m_coarse_min_area);
+
+    m_coarse_max_regions.addConstraint("1");
+    m_coarse_max_regions.addConstraint("64");
+    registerProperty(m_coarse_max_regions);
+
+    LOG(LTRACE) << "Hello ColorSegment\n";
+}
+
+ColorSegment::~ColorSegment()
+{
+    LOG(LTRACE) << "Good bye ColorSegment\n";
+}
+
+void ColorSegment::prepareInterface()
+{
+
+    LOG(LTRACE) << "ColorSegment::initialize\n";
+
+    h_onNewImage.setup(this, &ColorSegment::onNewImage);
+    registerHandler("onNewImage", &h_onNewImage);
+
+    registerStream("in_img", &in_img);
+    addDependency("onNewImage", &in_img);
+
+    // region of interest is optional, last received one is used
+    registerStream("in_roi", &in_roi);
+
+    registerStream("out_hue", &out_hue);
+    registerStream("out_segments", &out_segments);
+    registerStream("out_runs", &out_runs);
+
+}
+
+bool ColorSegment::onInit()
+{
+    return true;
+}
+
+bool ColorSegment::onFinish()
+{
+    LOG(LTRACE) << "ColorSegment::finish\n";
+
+    return true;
+}
+
+bool ColorSegment::onStep()
+{
+    LOG(LTRACE) << "ColorSegment::step\n";
+    return true;
+}
+
+bool ColorSegment::onStop()
+{
+    return true;
+}
+
+bool ColorSegment::onStart()
+{
+    return true;
+}
+
+void ColorSegment::onNewImage()
+{
+    LOG(LTRACE) << "ColorSegment::onNewImage\n";
+    try {
+        cv::Mat bgr_img = in_img.read();
+
+        if (in_roi.fresh())
+            m_roi = in_roi.read();
+
+        cv::Size size = bgr_img.size();
+        cv::Rect roi = Types::Blueball::clampRoi(m_roi, size);
+
+        m_segments_pool.setCapacity(m_buffers);
+        cv::Mat segments = m_segments_pool.get(size, CV_8UC1);
+
+        bool produce_hue = m_produce_hue;
+        cv::Mat hue_img;
+        if (produce_hue) {
+            m_hue_pool.setCapacity(m_buffers);
+            hue_img = m_hue_pool.get(size, CV_8UC1);
+        }
+
+        if (m_segmenter.setKernel(m_kernel))
+            LOG(LINFO) << "ColorSegment: using " << m_segmenter.kernel() << " segmentation kernel\n";
+
+        Types::Blueball::HSVThresholds thr = Types::Blueball::makeThresholds(H(m_hue_threshold_1), H(m_hue_threshold_2),
+                m_sat_threshold_1, m_val_threshold_1);
+        if (int failed = m_segmenter.setThresholds(thr, m_extra_regions))
+            LOG(LWARNING) << "ColorSegment: " << failed << " of extra regions ignored\n";
+
+        m_regions.clear();
+        if (m_coarse_scale > 1 && roi.width >= m_coarse_scale && roi.height >= m_coarse_scale) {
+            // Only neighbourhoods of blobs found in sparse sample are
+            // converted and segmented, rest of the outputs is cleared
+            m_coarse.configure(m_coarse_scale, m_coarse_margin, m_coarse_min_area, m_coarse_max_regions);
+            m_regions = m_coarse.find(m_segmenter, bgr_img, roi);
+            segments.setTo(0);
+            if (produce_hue)
+                hue_img.setTo(0);
+        } else {
+            // Only the region of interest is converted and segmented,
+            // rest of the outputs is cleared
+            m_regions.push_back(roi);
+            if (roi.size() != size) {
+                Types::Blueball::clearOutside(segments, roi);
+                if (produce_hue)
+                    Types::Blueball::clearOutside(hue_img, roi);
+            }
+        }
+
+        for (size_t i = 0; i < m_regions.size(); ++i) {
+            // Number of rows converted at once, strip should stay in cache
+            // until it is labeled.
+            int strip_rows = m_strip_bytes / std::max(1, 3 * m_regions[i].width);
+            Types::Blueball::segmentBgr(m_segmenter, bgr_img, m_regions[i], strip_rows, hsv_strip, segments, hue_img);
+        }
+
+        if (m_produce_runs) {
+            m_runs_pool.setCapacity(m_buffers);
+            Types::Blueball::SharedPool<Types::Blueball::RunMask>::Pointer runs = m_runs_pool.get();
+            Types::Blueball::encodeRuns(segments, m_regions, *runs);
+            out_runs.write(runs);
+        }
+
+        if (produce_hue)
+            out_hue.write(hue_img);
+        out_segments.write(segments);
+
+    }
+    catch (Common::DisCODeException& ex) {
+        LOG(LERROR) << ex.what() << "\n";
+        ex.printStackTrace();
+        exit(EXIT_FAILURE);
+    }
+    catch (const char * ex) {
+        LOG(LERROR) << ex;
+    }
+    catch (...) {
+        LOG(LERROR) << "ColorSegment::onNewImage failed\n";
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Processors
@@ -0,0 +1,178 @@
+/*!
+ * \file ColorSegment.hpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef COLOR_SEGMENT_HPP_
+#define COLOR_SEGMENT_HPP_
+
+#include "Component_Aux.hpp"
+#include "Component.hpp"
+#include "DataStream.hpp"
+
+#include "Property.hpp"
+
+#include <opencv2/opencv.hpp>
+#include <highgui.h>
+
+#include "Types/HSVSegmenter.hpp"
+#include "Types/BgrSegmentation.hpp"
+#include "Types/MatPool.hpp"
+#include "Types/Runs.hpp"
+#include "Types/SharedPool.hpp"
+#include "Types/SearchWindow.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+using namespace cv;
+
+/*!
+ * \class ColorSegment
+ * \brief Segments BGR image with LUT thresholds without storing HSV frame.
+ *
+ * Image is converted to HSV in strips of a few rows, each strip is
+ * labeled while it is still in cache. Properties are the same as in LUT,
+ * so ColorSegment can replace a CvColorConv (BGR2HSV) + LUT pair.
+ *
+ * In coarse-to-fine mode (coarse_scale > 1) only a sparse sample of the
+ * image is converted first, then only neighbourhoods of blobs found in
+ * it are converted and segmented at full resolution (see CoarseRegions).
+ * Both outputs are zero elsewhere, and out_runs covers just these
+ * regions, so run-based stages downstream scale with them too.
+ */
+class ColorSegment: public Base::Component
+{
+public:
+    /*!
+     * Constructor.
+     */
+    ColorSegment(const std::string & name = "");
+
+    /*!
+     * Destructor
+     */
+    virtual ~ColorSegment();
+
+
+    void prepareInterface();
+
+protected:
+
+    /*!
+     * Connects source to given device.
+     */
+    bool onInit();
+
+    /*!
+     * Disconnect source from device, closes streams, etc.
+     */
+    bool onFinish();
+
+    /*!
+     * Retrieves data from device.
+     */
+    bool onStep();
+
+    /*!
+     * Start component
+     */
+    bool onStart();
+
+    /*!
+     * Stop component
+     */
+    bool onStop();
+
+
+    /*!
+     * Event handler function.
+     */
+    void onNewImage();
+
+    /// Event handler.
+    Base::EventHandler <ColorSegment> h_onNewImage;
+
+    /// Input image - BGR
+    Base::DataStreamIn <Mat> in_img;
+
+    /// Optional input - region to segment, empty rectangle means whole image
+    Base::DataStreamIn <cv::Rect> in_roi;
+
+    /// Output data stream - hue part with continous red
+    Base::DataStreamOut <Mat> out_hue;
+
+    /// Output data stream - segments
+    Base::DataStreamOut <Mat> out_segments;
+
+    /// Output data stream - runs of segmented pixels, only the segmented regions are scanned
+    Base::DataStreamOut <Types::Blueball::SharedRunMask> out_runs;
+
+private:
+    /// Last region received from in_roi.
+    cv::Rect m_roi;
+
+    /// Output buffers, recycled once downstream components release them.
+    Types::Blueball::MatPool m_hue_pool;
+    Types::Blueball::MatPool m_segments_pool;
+    Types::Blueball::SharedPool<Types::Blueball::RunMask> m_runs_pool;
+
+    /// HSV strip reused between frames.
+    cv::Mat hsv_strip;
+
+    /// Regions segmented at full resolution in the current frame.
+    std::vector<cv::Rect> m_regions;
+
+    /// Coarse pass of coarse-to-fine mode.
+    Types::Blueball::CoarseRegions m_coarse;
+
+    Base::Property<int> m_hue_threshold_1;
+    Base::Property<int> m_hue_threshold_2;
+    Base::Property<int> m_sat_threshold_1;
+    Base::Property<int> m_val_threshold_1;
+
+    /// Segmentation kernel: auto, scalar, sse4, avx2 or table.
+    Base::Property<std::string> m_kernel;
+
+    /// Additional "hue_1:hue_2:sat:val" boxes labeled in table mode, separated by ';'.
+    Base::Property<std::string> m_extra_regions;
+
+    /// Size of HSV strip in bytes, number of rows per strip is derived from it.
+    Base::Property<int> m_strip_bytes;
+
+    /// Number of buffers kept for each output stream.
+    Base::Property<int> m_buffers;
+
+    /// Whether hue image is written to out_hue, disable when it has no sinks.
+    Base::Property<bool> m_produce_hue;
+
+    /// Whether run-length encoded mask is written to out_runs.
+    Base::Property<bool> m_produce_runs;
+
+    /// Size of a cell sampled in coarse pass, 1 - segment whole image at full resolution.
+    Base::Property<int> m_coarse_scale;
+
+    /// Margin (in full resolution pixels) around blobs of coarse pass.
+    Base::Property<int> m_coarse_margin;
+
+    /// Minimal blob area in coarse pass, in cells.
+    Base::Property<int> m_coarse_min_area;
+
+    /// Maximal number of coarse blobs segmented at full resolution, the largest ones are taken.
+    Base::Property<int> m_coarse_max_regions;
+
+    Types::Blueball::HSVSegmenter m_segmenter;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+
+/*
+ * Register processor component.
+ */
+REGISTER_COMPONENT("ColorSegment", Processors::Blueball::ColorSegment)
+
+#endif /* COLOR_SEGMENT_HPP_ */
@@ -5,6 +5,7 @@
  * \date 2010-07-05
  */
 
+#include <algorithm>
 #include <memory>
 #include <string>
 #include <math.h>
@@ -20,8 +21,32 @@ namespace Blueball {
 // OpenCV writes hue in range 0..180 instead of 0..360
 #define H(x) (x>>1)
 
-FeatureExtraction::FeatureExtraction(const std::string & name) : Base::Component(name)
+FeatureExtraction::FeatureExtraction(const std::string & name) : Base::Component(name),
+    m_roi_margin("roi_margin", 2.0, "range"),
+    m_roi_max_misses("roi_max_misses", 3, "range"),
+    m_max_balls("max_balls", 1, "range"),
+    m_draw_balls("draw_balls", false),
+    m_produce_candidates("produce_candidates", false),
+    m_hue_histogram("hue_histogram", false),
+    m_refine_edges("refine_edges", false),
+    m_frame_id(0)
 {
+    m_roi_margin.addConstraint("1.0");
+    m_roi_margin.addConstraint("10.0");
+    registerProperty(m_roi_margin);
+
+    m_roi_max_misses.addConstraint("0");
+    m_roi_max_misses.addConstraint("100");
+    registerProperty(m_roi_max_misses);
+
+    m_max_balls.addConstraint("1");
+    m_max_balls.addConstraint("64");
+    registerProperty(m_max_balls);
+    registerProperty(m_draw_balls);
+    registerProperty(m_produce_candidates);
+    registerProperty(m_hue_histogram);
+    registerProperty(m_refine_edges);
+
     LOG(LTRACE) << "Hello FeatureExtraction\n";
     blobs_ready = hue_ready = false;
 }
@@ -39,15 +64,25 @@ void FeatureExtraction::prepareInterface()
     h_onStep.setup(this, &FeatureExtraction::onStep);
     registerHandler("onStep", &h_onStep);
 
+    h_onRunBlobs.setup(this, &FeatureExtraction::onRunBlobs);
+    registerHandler("onRunBlobs", &h_onRunBlobs);
+
     // Register input streams.
     registerStream("in_blobs", &in_blobs);
     registerStream("in_hue", &in_hue);
+    registerStream("in_hsv", &in_hsv);
     registerStream("in_cameraInfo", &in_cameraInfo);
+    registerStream("in_runBlobs", &in_runBlobs);
+
+    // mask and hue are optional - last received hue is used, mask only if it comes with in_blobs
+    registerStream("in_segments", &in_segments);
 
     addDependency("onStep", &in_blobs);
-    addDependency("onStep", &in_hue);
     addDependency("onStep", &in_cameraInfo);
 
+    addDependency("onRunBlobs", &in_runBlobs);
+    addDependency("onRunBlobs", &in_cameraInfo);
+
     //	found = registerEvent("Found");
     //notFound = registerEvent("NotFound");
     //newImage = registerEvent("newImage");
@@ -56,6 +91,8 @@ void FeatureExtraction::prepareInterface()
     registerStream("out_balls", &out_balls);
     registerStream("out_imagePosition", &out_imagePosition);
     registerStream("out_features", &out_features);
+    registerStream("out_roi", &out_roi);
+    registerStream("out_candidates", &out_candidates);
 
 }
 
@@ -80,105 +117,187 @@ void FeatureExtraction::onStep()
 
     blobs = in_blobs.read();
     cameraInfo = in_cameraInfo.read();
-    hue_img = in_hue.read();
+    if (in_hue.fresh())
+        hue_img = in_hue.read();
+    if (in_hsv.fresh())
+        hsv_img = in_hsv.read();
+    // moments are taken from the mask only if it came with this frame's blobs,
+    // an older mask would not match them
+    bool segments_ready = in_segments.fresh();
+    if (segments_ready)
+        segments = in_segments.read();
+
+    ++m_frame_id;
 
     try {
-        int id = 0;
-        int i;
         Types::Blobs::Blob currentBlob;
-        Types::DrawableContainer Blueballs;
+        m_candidates.clear();
+
+        // All components of the mask, with moments, in one pass over its runs.
+        m_mask_blobs.clear();
+        if (segments_ready && !segments.empty()) {
+            m_labeler.reset();
+            m_labeler.addMask(segments, cv::Rect(0, 0, segments.cols, segments.rows));
+            m_labeler.finish(m_mask_blobs);
+        }
+
         // Check whether there is any blue blob detected.
+        int count = std::min(blobs.GetNumBlobs(), (int) m_max_balls);
+        for (int i = 0; i < count; ++i) {
+            blobs.GetNthBlob(Types::Blobs::BlobGetArea(), i, currentBlob);
+
+            // Other blobs may reach into the bounding box of this one, so the
+            // component is matched by its own box and area.
+            int match = Types::Blueball::matchBlob(m_mask_blobs, currentBlob.GetBoundingBox(), currentBlob.Area());
+            if (match >= 0) {
+                addCandidate(m_mask_blobs[match].moments);
+                continue;
+            }
+
+            // calculate moments
+            Types::Blueball::RawMoments moments;
+            moments.m00 = currentBlob.Moment(0,0);
+            moments.m01 = currentBlob.Moment(0,1);
+            moments.m10 = currentBlob.Moment(1,0);
+            moments.m11 = currentBlob.Moment(1,1);
+            moments.m02 = currentBlob.Moment(0,2);
+            moments.m20 = currentBlob.Moment(2,0);
+
+            addCandidate(moments);
+        }
 
-        if (blobs.GetNumBlobs() <0) {
+        if (m_candidates.empty()) {
             LOG(LTRACE) << "Blue blob not found.\n";
+            processMiss();
+            return;
+        }
+
+        writeCandidates();
 
-            // Disregarding the fact - write output stream.
-            out_balls.write(Blueballs);
-            // Raise events.
-            //notFound->raise();
-            //newImage->raise();
+    } catch (...) {
+        LOG(LERROR) << "FeatureExtraction::onNewImage failed\n";
+    }
+}
+
+void FeatureExtraction::onRunBlobs()
+{
+    LOG(LTRACE) << "FeatureExtraction::onRunBlobs\n";
+
+    // shared with the producer, nothing is copied
+    Types::Blueball::SharedRunBlobs run_blobs = in_runBlobs.read();
+    cameraInfo = in_cameraInfo.read();
+    if (in_hue.fresh())
+        hue_img = in_hue.read();
+    if (in_hsv.fresh())
+        hsv_img = in_hsv.read();
+
+    ++m_frame_id;
+
+    try {
+        m_candidates.clear();
+
+        // Blobs are sorted, the largest one comes first.
+        int count = run_blobs ? std::min((int) run_blobs->size(), (int) m_max_balls) : 0;
+        for (int i = 0; i < count; ++i) {
+            addCandidate((*run_blobs)[i].moments);
+        }
+
+        if (m_candidates.empty()) {
+            LOG(LTRACE) << "Blue blob not found.\n";
+            processMiss();
+            return;
         }
 
-        blobs.GetNthBlob(Types::Blobs::BlobGetArea(), 0, currentBlob);
+        writeCandidates();
 
+    } catch (...) {
+        LOG(LERROR) << "FeatureExtraction::onRunBlobs failed\n";
+    }
+}
 
-        // get blob bounding rectangle and ellipse
-        CvBox2D r2 = currentBlob.GetEllipse();
+void FeatureExtraction::processMiss()
+{
+    m_search_window.setMargin(m_roi_margin);
+    m_search_window.setMaxMisses(m_roi_max_misses);
 
-        //std::cout << "Center: " << r2.center.x << "," << r2.center.y << "\n";
-        ++id;
+    // Disregarding the fact - write output stream.
+    if (m_draw_balls) {
+        Types::DrawableContainer Blueballs;
+        out_balls.write(Blueballs);
+    }
+    if (m_produce_candidates)
+        out_candidates.write(m_candidates);
+    out_roi.write(m_search_window.missed(cameraInfo));
+    // Raise events.
+    //notFound->raise();
+    //newImage->raise();
+}
 
-        // blob moments
-        double m00, m10, m01, m11, m02, m20;
-        double M11, M02, M20, M7, a, b, wsp_elips;
+void FeatureExtraction::addCandidate(const Types::Blueball::RawMoments& moments)
+{
+    if (moments.m00 <= 0)
+        return;
 
-        // calculate moments
-        m00 = currentBlob.Moment(0,0);
-        m01 = currentBlob.Moment(0,1);
-        m10 = currentBlob.Moment(1,0);
-        m11 = currentBlob.Moment(1,1);
-        m02 = currentBlob.Moment(0,2);
-        m20 = currentBlob.Moment(2,0);
+    Types::Blueball::BallCandidate ball;
+    Types::Blueball::describeBlob(moments, hue_img, hsv_img, m_refine_edges, m_hue_histogram, ball);
+    ball.features.timestamp = cv::getTickCount();
+    ball.features.frame_id = m_frame_id;
 
-        M11 = m11 - (m10*m01)/m00;
-        M02 = m02 - (m01*m01)/m00;
-        M20 = m20 - (m10*m10)/m00;
-        // for circle it should be ~0.0063
-        M7 = (M20*M02-M11*M11) / (m00*m00*m00*m00);
+    m_candidates.push_back(ball);
+}
 
-        a=sqrt(2*(M20+M02+sqrt(M11*M11+(M20-M02)*(M20-M02))));
-        b=sqrt(2*(M20+M02-sqrt(M11*M11+(M20-M02)*(M20-M02))));
-        wsp_elips=b/a;
+void FeatureExtraction::writeCandidates()
+{
+    m_search_window.setMargin(m_roi_margin);
+    m_search_window.setMaxMisses(m_roi_max_misses);
 
-        Types::Ellipse* tmpball = new Types::Ellipse(Point(r2.center.x, r2.center.y), Size(r2.size.width, r2.size.height), r2.angle);
+    if (m_draw_balls) {
+        Types::DrawableContainer Blueballs;
 
-        // Add to list.
-        Blueballs.add(tmpball);
+        for (size_t i = 0; i < m_candidates.size(); ++i) {
+            const cv::RotatedRect& e = m_candidates[i].ellipse;
+            Types::Ellipse* tmpball = new Types::Ellipse(Point(e.center.x, e.center.y), Size(e.size.width, e.size.height), e.angle);
+
+            // Add to list.
+            Blueballs.add(tmpball);
+        }
 
         // Write blueball list to stream.
         out_balls.write(Blueballs);
+    }
 
-        vector<double> features;
-
-        double maxPixels = std::max(cameraInfo.width, cameraInfo.height);
-        double diameter=std::max(r2.size.width, r2.size.height)/maxPixels;
-        double _a = std::max(r2.size.width, r2.size.height)/2;
-        double _b = std::min(r2.size.width, r2.size.height)/2;
-        double convexity = _b/_a;
-        double area = M_PI*4*_a*_b;
-
-        features.push_back(_a);
-        features.push_back(_b);
-        features.push_back(convexity);
-        features.push_back(area);
-        out_features.write(features);
-
-        //std::cout << a/maxPixels << "\t" << b/maxPixels << "\t" << area << std::endl;
-
-        Types::ImagePosition imagePosition;
-        //std::cout << "\n ================== New image ===================== \n";
-        //std::cout << "a: " << _a <<std::endl;
-        //std::cout << "b: " << _b <<std::endl;
-        //std::cout << "b/a: " << _b/_a <<std::endl;
-        //std::cout << "pole: " << M_PI*4*_a*_b <<std::endl;
-        //std::cout << "Srednica: " <<  std::max(r2.size.width, r2.size.height)<<std::endl;
-        // Change coordinate system hence it will return coordinates from (-1,1), center is 0.
-        imagePosition.elements[0] = (r2.center.x - cameraInfo.width / 2) / maxPixels;
-        imagePosition.elements[1] = (r2.center.y - cameraInfo.height / 2) / maxPixels;
-        // Elipse factor
-        imagePosition.elements[2] = diameter;
-        // Rotation - in case of blueball - zero.
-        imagePosition.elements[3] = wsp_elips;
-
-        // Area of an object
-        //imagePosition.elements[2] = area;
-
-        // Write to stream.
-        out_imagePosition.write(imagePosition);
+    if (m_produce_candidates)
+        out_candidates.write(m_candidates);
 
-    } catch (...) {
-        LOG(LERROR) << "FeatureExtraction::onNewImage failed\n";
-    }
+    // Single-ball outputs describe the largest candidate.
+    const Types::Blueball::BallCandidate& ball = m_candidates[0];
+    const cv::RotatedRect& r2 = ball.ellipse;
+
+    // look around the ball in the next frame
+    float ball_size = std::max(r2.size.width, r2.size.height);
+    out_roi.write(m_search_window.found(r2.center, Size2f(ball_size, ball_size), cameraInfo));
+
+    //std::cout << "Center: " << r2.center.x << "," << r2.center.y << "\n";
+
+    double maxPixels = std::max(cameraInfo.width, cameraInfo.height);
+    double diameter=std::max(r2.size.width, r2.size.height)/maxPixels;
+
+    out_features.write(ball.features);
+
+    Types::ImagePosition imagePosition;
+    // Change coordinate system hence it will return coordinates from (-1,1), center is 0.
+    imagePosition.elements[0] = (r2.center.x - cameraInfo.width / 2) / maxPixels;
+    imagePosition.elements[1] = (r2.center.y - cameraInfo.height / 2) / maxPixels;
+    // Elipse factor
+    imagePosition.elements[2] = diameter;
+    // Flatness - minor to major axis ratio of the refined ellipse.
+    imagePosition.elements[3] = ball.axis_ratio;
+
+    // Area of an object
+    //imagePosition.elements[2] = area;
+
+    // Write to stream.
+    out_imagePosition.write(imagePosition);
 }
 
 bool FeatureExtraction::onStop()
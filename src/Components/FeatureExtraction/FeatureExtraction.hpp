@@ -12,6 +12,8 @@
 #include "Component.hpp"
 #include "DataStream.hpp"
 
+#include "Property.hpp"
+
 #include <opencv2/opencv.hpp>
 #include <highgui.h>
 
@@ -20,6 +22,9 @@
 #include "Types/BlobResult.hpp"
 #include "Types/DrawableContainer.hpp"
 #include "Types/ImagePosition.hpp"
+#include "Types/SearchWindow.hpp"
+#include "Types/Runs.hpp"
+#include "Types/BallCandidate.hpp"
 
 namespace Processors {
 namespace Blueball {
@@ -71,6 +76,11 @@ protected:
      */
     void onStep();
 
+    /*!
+     * Processes blobs found in run-length encoded mask.
+     */
+    void onRunBlobs();
+
     /*!
      * Start component
      */
@@ -84,12 +94,25 @@ protected:
 
     /// New image is waiting
     Base::EventHandler <FeatureExtraction> h_onStep;
-    /// Input blobs
+
+    /// Blobs from RunBlobExtractor are waiting
+    Base::EventHandler <FeatureExtraction> h_onRunBlobs;
+
+    /// Input blobs, copied on each read - in_runBlobs path doesn't allocate
     Base::DataStreamIn <Types::Blobs::BlobResult> in_blobs;
 
-    /// Input hue image
+    /// Optional input - mask in which in_blobs were found, moments are computed from it when it comes with in_blobs
+    Base::DataStreamIn <cv::Mat> in_segments;
+
+    /// Input blobs - alternative to in_blobs, computed from runs (e.g. by RunBlobExtractor)
+    Base::DataStreamIn <Types::Blueball::SharedRunBlobs> in_runBlobs;
+
+    /// Optional input - hue image, used for hue histogram and edge refinement
     Base::DataStreamIn <cv::Mat> in_hue;
 
+    /// Optional input - HSV image, used instead of in_hue for hue and saturation histograms
+    Base::DataStreamIn <cv::Mat> in_hsv;
+
     /// Input data stream containing camera properties.
     Base::DataStreamIn <cv::Size> in_cameraInfo;
 
@@ -102,13 +125,36 @@ protected:
     /// Position of the blueball in image coordinates.
     Base::DataStreamOut <Types::ImagePosition> out_imagePosition;
 
-    Base::DataStreamOut < vector<double> > out_features;
+    /// Features of the largest ball.
+    Base::DataStreamOut <Types::Blueball::BallFeatures> out_features;
+
+    /// Window in which the ball is expected in the next frame, empty - search whole image.
+    Base::DataStreamOut <cv::Rect> out_roi;
+
+    /// Up to max_balls largest blobs with their features, the largest first (see produce_candidates).
+    Base::DataStreamOut <Types::Blueball::BallCandidates> out_candidates;
 
     /// Properties
     //Props props;
 
 private:
+    /*!
+     * Fits ellipse to the blob with given raw moments and computes its features.
+     */
+    void addCandidate(const Types::Blueball::RawMoments& moments);
+
+    /*!
+     * Writes outputs for all candidates found in the image.
+     */
+    void writeCandidates();
+
+    /*!
+     * Writes outputs when there is no ball in the image.
+     */
+    void processMiss();
+
     cv::Mat hue_img;
+    cv::Mat hsv_img;
     cv::Mat segments;
 
     bool blobs_ready;
@@ -118,6 +164,40 @@ private:
 
     // Data related to the utilized camera.
     cv::Size cameraInfo;
+
+    /// Labels in_segments, its components are matched to in_blobs.
+    Types::Blueball::RunLabeler m_labeler;
+    Types::Blueball::RunBlobs m_mask_blobs;
+
+    /// Predicts out_roi from the ball position.
+    Types::Blueball::SearchWindow m_search_window;
+
+    /// Ratio of search window size to ball size.
+    Base::Property<double> m_roi_margin;
+
+    /// Number of frames without ball after which whole image is searched again.
+    Base::Property<int> m_roi_max_misses;
+
+    /// Number of the largest blobs described in each frame.
+    Base::Property<int> m_max_balls;
+
+    /// Whether ellipses are drawn to out_balls, off by default as each drawing allocates.
+    Base::Property<bool> m_draw_balls;
+
+    /// Whether out_candidates is written.
+    Base::Property<bool> m_produce_candidates;
+
+    /// Whether hue histogram inside the ellipse is added to features (needs in_hue, or in_hsv to add saturation too).
+    Base::Property<bool> m_hue_histogram;
+
+    /// Whether ellipse is refined to sub-pixel edges in hue image (needs in_hue).
+    Base::Property<bool> m_refine_edges;
+
+    /// Candidates of the current frame, storage is reused between frames.
+    Types::Blueball::BallCandidates m_candidates;
+
+    /// Number of processed frames.
+    int m_frame_id;
 };
 
 }//: namespace Blueball
@@ -0,0 +1,152 @@
+/*!
+ * \file CompiledNetwork.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include "CompiledNetwork.hpp"
+
+#include <algorithm>
+
+namespace Processors {
+namespace Blueball {
+
+CompiledNetwork::CompiledNetwork() :
+    m_ready(false), m_nodes(0), m_joint_states(0)
+{
+}
+
+bool CompiledNetwork::compile(DSL_network& net, int max_states)
+{
+    m_ready = false;
+
+    std::vector<int> handles;
+    int max_handle = -1;
+    for (int h = net.GetFirstNode(); h >= 0; h = net.GetNextNode(h)) {
+        handles.push_back(h);
+        max_handle = std::max(max_handle, h);
+    }
+    if (handles.empty())
+        return false;
+
+    m_nodes = handles.size();
+    m_index.assign(max_handle + 1, -1);
+    m_offsets.resize(m_nodes);
+    m_outcomes.resize(m_nodes);
+    m_cpt_offsets.resize(m_nodes);
+    m_cpt.clear();
+
+    int outcomes_total = 0;
+    m_joint_states = 1;
+    for (int n = 0; n < m_nodes; ++n) {
+        DSL_nodeDefinition* definition = net.GetNode(handles[n])->Definition();
+        if (definition->GetType() != DSL_CPT)
+            return false;
+
+        int outcomes = definition->GetNumberOfOutcomes();
+        if (outcomes <= 0 || m_joint_states > max_states / outcomes)
+            return false;
+        m_joint_states *= outcomes;
+
+        m_index[handles[n]] = n;
+        m_outcomes[n] = outcomes;
+        m_offsets[n] = outcomes_total;
+        outcomes_total += outcomes;
+
+        DSL_Dmatrix* cpt = NULL;
+        definition->GetDefinition(&cpt);
+        m_cpt_offsets[n] = m_cpt.size();
+        for (int i = 0; i < cpt->GetSize(); ++i)
+            m_cpt.push_back((*cpt)[i]);
+    }
+
+    m_likelihoods.assign(outcomes_total, 1.0);
+    m_posteriors.assign(outcomes_total, 0.0);
+
+    // outcome of node n in joint state j is (j / stride[n]) % outcomes[n]
+    std::vector<int> stride(m_nodes);
+    for (int n = 0, s = 1; n < m_nodes; s *= m_outcomes[n], ++n)
+        stride[n] = s;
+
+    m_cpt_terms.resize(m_joint_states * m_nodes);
+    m_outcome_terms.resize(m_joint_states * m_nodes);
+    std::vector<int> state(m_nodes);
+    for (int j = 0; j < m_joint_states; ++j) {
+        for (int n = 0; n < m_nodes; ++n)
+            state[n] = (j / stride[n]) % m_outcomes[n];
+
+        for (int n = 0; n < m_nodes; ++n) {
+            const DSL_intArray& parents = net.GetParents(handles[n]);
+            int entry = 0;
+            for (int p = 0; p < parents.GetSize(); ++p) {
+                int parent = m_index[parents[p]];
+                entry = entry * m_outcomes[parent] + state[parent];
+            }
+            entry = entry * m_outcomes[n] + state[n];
+
+            m_cpt_terms[j * m_nodes + n] = m_cpt_offsets[n] + entry;
+            m_outcome_terms[j * m_nodes + n] = m_offsets[n] + state[n];
+        }
+    }
+
+    m_ready = true;
+    return true;
+}
+
+void CompiledNetwork::setPrior(int node, const double* probabilities)
+{
+    int n = m_index[node];
+    std::copy(probabilities, probabilities + m_outcomes[n], m_cpt.begin() + m_cpt_offsets[n]);
+}
+
+void CompiledNetwork::setEvidence(int node, int outcome)
+{
+    int n = m_index[node];
+    double* likelihood = &m_likelihoods[m_offsets[n]];
+    for (int i = 0; i < m_outcomes[n]; ++i)
+        likelihood[i] = (i == outcome);
+}
+
+void CompiledNetwork::setLikelihood(int node, const double* likelihoods)
+{
+    int n = m_index[node];
+    std::copy(likelihoods, likelihoods + m_outcomes[n], m_likelihoods.begin() + m_offsets[n]);
+}
+
+void CompiledNetwork::clearEvidence(int node)
+{
+    int n = m_index[node];
+    std::fill(m_likelihoods.begin() + m_offsets[n], m_likelihoods.begin() + m_offsets[n] + m_outcomes[n], 1.0);
+}
+
+void CompiledNetwork::update()
+{
+    std::fill(m_posteriors.begin(), m_posteriors.end(), 0.0);
+
+    const double* cpt = &m_cpt[0];
+    const double* likelihoods = &m_likelihoods[0];
+    double* posteriors = &m_posteriors[0];
+
+    double total = 0;
+    for (int j = 0; j < m_joint_states; ++j) {
+        const int* cpt_terms = &m_cpt_terms[j * m_nodes];
+        const int* outcome_terms = &m_outcome_terms[j * m_nodes];
+
+        double p = 1;
+        for (int n = 0; n < m_nodes; ++n)
+            p *= cpt[cpt_terms[n]] * likelihoods[outcome_terms[n]];
+        for (int n = 0; n < m_nodes; ++n)
+            posteriors[outcome_terms[n]] += p;
+        total += p;
+    }
+
+    if (total > 0) {
+        double scale = 1.0 / total;
+        for (size_t i = 0; i < m_posteriors.size(); ++i)
+            posteriors[i] *= scale;
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Processors
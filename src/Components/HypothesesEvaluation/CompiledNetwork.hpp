@@ -0,0 +1,110 @@
+/*!
+ * \file CompiledNetwork.hpp
+ * \brief Exact inference in small discrete networks by flat enumeration.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef COMPILED_NETWORK_HPP_
+#define COMPILED_NETWORK_HPP_
+
+#include <vector>
+
+#include "../../../lib/SMILE/smile.h"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class CompiledNetwork
+ * \brief Copy of a small CPT-only network, evaluated without SMILE.
+ *
+ * compile() enumerates the joint states of the network once and stores,
+ * for each of them, the CPT entry of every node and the marginal it adds
+ * to. update() is then a fixed sequence of multiply-adds over these flat
+ * tables: posterior of each outcome is the normalized sum of products of
+ * CPT entries and evidence likelihoods over the joint states.
+ *
+ * Nodes are addressed by their SMILE handles and outcome indices, so the
+ * same NetworkBinding serves both backends.
+ */
+class CompiledNetwork
+{
+public:
+    CompiledNetwork();
+
+    /*!
+     * Copies CPTs and structure of the network.
+     * \param max_states largest number of joint states still compiled
+     * \returns false if network is too large or has non-CPT nodes;
+     * ready() is then false and SMILE must be used.
+     */
+    bool compile(DSL_network& net, int max_states);
+
+    bool ready() const
+    {
+        return m_ready;
+    }
+
+    /// Number of joint states enumerated by update().
+    int states() const
+    {
+        return m_joint_states;
+    }
+
+    /// Replaces distribution of a root node.
+    void setPrior(int node, const double* probabilities);
+
+    /// Observes given outcome of a node.
+    void setEvidence(int node, int outcome);
+
+    /// Sets likelihood of each outcome of a node (virtual evidence).
+    void setLikelihood(int node, const double* likelihoods);
+
+    /// Removes evidence from a node.
+    void clearEvidence(int node);
+
+    /// Recomputes all posteriors.
+    void update();
+
+    /// Posterior of an outcome, valid after update().
+    double posterior(int node, int outcome) const
+    {
+        return m_posteriors[m_offsets[m_index[node]] + outcome];
+    }
+
+private:
+    bool m_ready;
+
+    /// Number of nodes and of their joint states.
+    int m_nodes;
+    int m_joint_states;
+
+    /// Compact node index for each SMILE handle, -1 for unused handles.
+    std::vector<int> m_index;
+
+    /// Per node offset of its outcomes in m_likelihoods and m_posteriors.
+    std::vector<int> m_offsets;
+    std::vector<int> m_outcomes;
+
+    /// Per node offset of its CPT in m_cpt.
+    std::vector<int> m_cpt_offsets;
+
+    /// All CPTs, each in SMILE layout (parents first, own outcome last).
+    std::vector<double> m_cpt;
+
+    /// Evidence as likelihood of each outcome, 1 when unobserved.
+    std::vector<double> m_likelihoods;
+
+    /// Posterior of each outcome.
+    std::vector<double> m_posteriors;
+
+    /// For joint state j and node n, at j * m_nodes + n: index in m_cpt and outcome index.
+    std::vector<int> m_cpt_terms;
+    std::vector<int> m_outcome_terms;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+#endif /* COMPILED_NETWORK_HPP_ */
@@ -6,8 +6,10 @@
 #include <memory>
 #include <string>
 #include <cmath>
+#include <algorithm>
 
 #include "HypothesesEvaluation.hpp"
+#include "NetworkCache.hpp"
 #include "Common/Logger.hpp"
 
 namespace Processors {
@@ -15,13 +17,105 @@ namespace Blueball {
 
 using namespace cv;
 
-HypothesesEvaluation::HypothesesEvaluation(const std::string & name) : Base::Component(name)
+namespace {
+
+/*!
+ * Scores contiguous chunks of candidates, each chunk on its own copy of the network.
+ */
+class EvaluateChunks: public cv::ParallelLoopBody
 {
+public:
+    EvaluateChunks(const std::vector<boost::shared_ptr<NetworkEvaluator> >& pool, const NetworkBinding& binding,
+            const std::vector<double>& probabilities, std::vector<double>& posteriors, std::vector<int>& inferences,
+            int count, int chunks) :
+        m_pool(pool), m_binding(binding), m_probabilities(probabilities), m_posteriors(posteriors),
+        m_inferences(inferences), m_count(count), m_chunks(chunks)
+    {
+    }
+
+    void operator()(const cv::Range& range) const
+    {
+        for (int c = range.start; c < range.end; ++c) {
+            NetworkEvaluator& evaluator = *m_pool[c];
+            int begin = (int) ((int64) c * m_count / m_chunks);
+            int end = (int) ((int64) (c + 1) * m_count / m_chunks);
+            for (int i = begin; i < end; ++i) {
+                evaluator.applyEvidence(&m_probabilities[2 * i]);
+                if (evaluator.updateBeliefs())
+                    ++m_inferences[c];
+                m_posteriors[2 * i] = evaluator.posterior(m_binding.flat, m_binding.flat_yes);
+                m_posteriors[2 * i + 1] = evaluator.posterior(m_binding.nonflat, m_binding.nonflat_yes);
+            }
+        }
+    }
+
+private:
+    const std::vector<boost::shared_ptr<NetworkEvaluator> >& m_pool;
+    const NetworkBinding& m_binding;
+    const std::vector<double>& m_probabilities;
+    std::vector<double>& m_posteriors;
+    std::vector<int>& m_inferences;
+    int m_count;
+    int m_chunks;
+};
+
+}//: namespace
+
+HypothesesEvaluation::HypothesesEvaluation(const std::string & name) : Base::Component(name),
+    m_network_file("network_file", std::string("in_blueball_network.xdsl")),
+    m_compiled_max_states("compiled_max_states", 4096, "range"),
+    m_batch_threads("batch_threads", 0, "range"),
+    m_virtual_evidence("virtual_evidence", true),
+    m_temporal("temporal", false),
+    m_flat_persistence("flat_persistence", 0.9, "range"),
+    m_publish_complement(false),
+    m_history_window("history_window", 1000, "range"),
+    m_inference_count(0),
+    m_frame_inferences(0),
+    m_timing_frames("timing_frames", 100, "range"),
+    m_inference_ticks(0),
+    m_timed_frames(0),
+    m_frame_id(0),
+    m_timestamp(0),
+    m_async("async", false),
+    m_posted(0),
+    m_taken(0),
+    m_worker_running(false)
+{
+    registerProperty(m_network_file);
+
+    m_history_window.addConstraint("1");
+    m_history_window.addConstraint("1000000");
+    registerProperty(m_history_window);
+
+    m_compiled_max_states.addConstraint("0");
+    m_compiled_max_states.addConstraint("1048576");
+    registerProperty(m_compiled_max_states);
+
+    m_batch_threads.addConstraint("0");
+    m_batch_threads.addConstraint("64");
+    registerProperty(m_batch_threads);
+
+    registerProperty(m_virtual_evidence);
+
+    registerProperty(m_temporal);
+
+    m_flat_persistence.addConstraint("0.5");
+    m_flat_persistence.addConstraint("1.0");
+    registerProperty(m_flat_persistence);
+
+    m_timing_frames.addConstraint("0");
+    m_timing_frames.addConstraint("100000");
+    registerProperty(m_timing_frames);
+
+    registerProperty(m_async);
+
     LOG(LTRACE) << "Hello HypothesesEvaluation\n";
 }
 
 HypothesesEvaluation::~HypothesesEvaluation()
 {
+    stopWorker();
     LOG(LTRACE) << "Good bye HypothesesEvaluation\n";
 }
 
@@ -40,18 +134,30 @@ void HypothesesEvaluation::prepareInterface()
     registerStream("in_features", &in_features);
     addDependency("onNewImage", &in_features);
 
-    registerStream("out_probabilities", &out_probabilities);
+    h_onCandidates.setup(this, &HypothesesEvaluation::onCandidates);
+    registerHandler("onCandidates", &h_onCandidates);
 
-    initNetwork();
+    registerStream("in_candidates", &in_candidates);
+    addDependency("onCandidates", &in_candidates);
 
+    registerStream("out_probabilities", &out_probabilities);
+    registerStream("out_evaluation", &out_evaluation);
+    registerStream("out_inferences", &out_inferences);
 }
 
 void HypothesesEvaluation::initNetwork()
 {
-    //int result = theNet.ReadFile("/home/qiubix/DCL/BlueBall/in_blueball_network.xdsl", DSL_XDSL_FORMAT);
-    int result = theNet.ReadFile("/home/kkaterza/DCL/BlueBall/in_blueball_network.xdsl", DSL_XDSL_FORMAT);
+    std::string path = m_network_file;
+    int result = NetworkCache::load(path, theNet);
     //createNetwork();
-    LOG(LWARNING) << "Reading network file: " << result;
+    if (result != DSL_OKAY) {
+        LOG(LERROR) << "HypothesesEvaluation: can't load network " << path << ", evaluation disabled\n";
+        m_binding.valid = false;
+        return;
+    }
+
+    if (!m_binding.bind(theNet))
+        LOG(LERROR) << "HypothesesEvaluation: network does not match, evaluation disabled\n";
 }
 
 void HypothesesEvaluation::createNetwork()
@@ -142,13 +248,41 @@ void HypothesesEvaluation::createNetwork()
 bool HypothesesEvaluation::onInit()
 {
     LOG(LTRACE) << "HypothesesEvaluation::onInit()\n";
+
+    initNetwork();
+    m_pool.clear();
+    m_inference_ticks = 0;
+    m_timed_frames = 0;
+
+    if (!m_binding.valid)
         return true;
+
+    if (!m_evaluator.init(theNet, m_binding, m_compiled_max_states, m_virtual_evidence)) {
+        LOG(LERROR) << "HypothesesEvaluation: can't copy network, evaluation disabled\n";
+        m_binding.valid = false;
+        return true;
+    }
+
+    if (m_evaluator.compiled()) {
+        LOG(LINFO) << "HypothesesEvaluation: network compiled, " << m_evaluator.compiledNetwork().states() << " joint states\n";
+    } else {
+        LOG(LINFO) << "HypothesesEvaluation: using SMILE inference\n";
+    }
+    if (m_virtual_evidence && !m_evaluator.virtualEvidence()) {
+        LOG(LWARNING) << "HypothesesEvaluation: roots have parents or zero priors, virtual evidence not used\n";
+    }
+    if (m_temporal && !m_evaluator.nonflatComplementsFlat()) {
+        LOG(LINFO) << "HypothesesEvaluation: nonflat is not the complement of flat, its posterior is published\n";
+    }
+    return true;
 }
 
 bool HypothesesEvaluation::onFinish()
 {
     LOG(LTRACE) << "HypothesesEvaluation::finish\n";
 
+    stopWorker();
+
     return true;
 }
 
@@ -160,60 +294,204 @@ bool HypothesesEvaluation::onStep()
 
 bool HypothesesEvaluation::onStop()
 {
+    stopWorker();
     return true;
 }
 
 bool HypothesesEvaluation::onStart()
 {
+    // filtering starts from the prior, i.e. no information from previous frames
+    m_flat_belief[0] = m_evaluator.flatPrior()[0];
+    m_flat_belief[1] = m_evaluator.flatPrior()[1];
+    m_publish_complement = false;
+
+    if (m_async)
+        startWorker();
     return true;
 }
 
 void HypothesesEvaluation::onNewImage()
 {
-    std::cout << "\n";
-    theNet.SetDefaultBNAlgorithm(DSL_ALG_BN_LAURITZEN);
+    if (!m_binding.valid)
+        return;
+
+    Types::Blueball::BallFeatures newFeatures = in_features.read();
+
+    if (!m_worker) {
+        evaluate(newFeatures);
+        return;
+    }
 
-    std::vector<double> newFeatures = in_features.read();
+    // history and root probabilities stay on this thread, so every frame
+    // counts even if inference skips it
     updateFeatureVector(newFeatures);
 
+    InferenceRequest& request = m_mailbox.back();
+    calculateProbabilities(m_flatness_history.back(), m_area_history.back(), request.probabilities);
+    request.frame_id = newFeatures.frame_id;
+    request.timestamp = newFeatures.timestamp;
+    request.sequence = ++m_posted;
+
+    // never wait for inference: an unprocessed older frame is replaced
+    m_mailbox.post();
+    m_wakeup.notify_one();
+}
+
+void HypothesesEvaluation::evaluate(const Types::Blueball::BallFeatures& features)
+{
+    m_frame_id = features.frame_id;
+    m_timestamp = features.timestamp;
+
+    updateFeatureVector(features);
     calculateProbabilities();
-    updateNetwork(newProbabilities);
 
+    infer(newProbabilities, 1);
+}
+
+void HypothesesEvaluation::infer(const double* probabilities, int frames)
+{
+    beginFrame();
+    updateNetwork(probabilities, frames);
     computeDecision();
+    endFrame();
+}
+
+void HypothesesEvaluation::publish(const vector <double>& probabilities)
+{
+    Types::Blueball::BallEvaluation evaluation;
+    evaluation.frame_id = m_frame_id;
+    evaluation.timestamp = m_timestamp;
+    evaluation.probabilities = probabilities;
+
+    out_evaluation.write(evaluation);
+    out_probabilities.write(probabilities);
 }
 
-void HypothesesEvaluation::updateFeatureVector(const std::vector<double> newFeatures)
+void HypothesesEvaluation::startWorker()
 {
-    if(features.size() == 0) {
-        vector <double> flatness;
-        vector <double> area;
-        features.push_back(flatness);
-        features.push_back(area);
+    stopWorker();
+
+    // drop a request left from the previous run
+    m_mailbox.take();
+    m_posted = m_taken = 0;
+    m_worker_running = true;
+    m_worker.reset(new boost::thread(&HypothesesEvaluation::inferenceLoop, this));
+}
+
+void HypothesesEvaluation::stopWorker()
+{
+    if (!m_worker)
+        return;
+
+    m_worker_running = false;
+    m_wakeup.notify_one();
+    m_worker->join();
+    m_worker.reset();
+}
+
+void HypothesesEvaluation::inferenceLoop()
+{
+    while (m_worker_running) {
+        if (m_mailbox.take()) {
+            const InferenceRequest& request = m_mailbox.front();
+            int frames = (int) (request.sequence - m_taken);
+            if (frames > 1)
+                LOG(LDEBUG) << "HypothesesEvaluation: " << frames - 1 << " frame(s) not evaluated, inference is behind\n";
+            m_taken = request.sequence;
+
+            m_frame_id = request.frame_id;
+            m_timestamp = request.timestamp;
+            infer(request.probabilities, frames);
+            continue;
+        }
+
+        // timeout covers a notification sent between take() and wait
+        boost::mutex::scoped_lock lock(m_wakeup_mutex);
+        if (m_worker_running && !m_mailbox.ready())
+            m_wakeup.timed_wait(lock, boost::posix_time::milliseconds(10));
+    }
+}
+
+void HypothesesEvaluation::onCandidates()
+{
+    if (!m_binding.valid)
+        return;
+    if (m_worker) {
+        LOG(LWARNING) << "HypothesesEvaluation: in_candidates is not evaluated in async mode\n";
+        return;
+    }
+
+    Types::Blueball::BallCandidates candidates = in_candidates.read();
+    if (candidates.empty())
+        return;
+    beginFrame();
+
+    // area history follows the largest blob
+    updateFeatureVector(candidates[0].features);
+
+    vector <double> resultingProbabilities;
+    evaluateBatch(candidates, resultingProbabilities);
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        LOG(LDEBUG) << "HypothesesEvaluation: candidate " << i << " is flat: " << resultingProbabilities[2 * i] << "\n";
+    }
+    m_frame_id = candidates[0].features.frame_id;
+    m_timestamp = candidates[0].features.timestamp;
+    publish(resultingProbabilities);
+    endFrame();
+}
+
+void HypothesesEvaluation::beginFrame()
+{
+    m_frame_inferences = 0;
+}
+
+void HypothesesEvaluation::endFrame()
+{
+    LOG(LDEBUG) << "HypothesesEvaluation: " << m_frame_inferences << " inference(s) this frame, "
+                << m_inference_count << " in total\n";
+    out_inferences.write(m_frame_inferences);
+
+    // average time of evidence and inference, to compare virtual_evidence and compiled_max_states settings
+    if (m_timing_frames > 0 && ++m_timed_frames >= m_timing_frames) {
+        double ms = 1000.0 * m_inference_ticks / cv::getTickFrequency() / m_timed_frames;
+        LOG(LINFO) << "HypothesesEvaluation: inference " << ms << " ms per frame over " << m_timed_frames << " frames ("
+                   << (m_evaluator.compiled() ? "compiled" : "SMILE") << ", "
+                   << (m_evaluator.virtualEvidence() ? "virtual evidence" : "root definitions") << ")\n";
+        m_inference_ticks = 0;
+        m_timed_frames = 0;
+    }
+}
+
+void HypothesesEvaluation::updateFeatureVector(const Types::Blueball::BallFeatures& newFeatures)
+{
+    if (m_area_history.capacity() != m_history_window) {
+        m_flatness_history.setCapacity(m_history_window);
+        m_area_history.setCapacity(m_history_window);
     }
     //double newDiameter = imagePosition.elements[2];
     //double newFlatness = imagePosition.elements[3];
     //double newArea = imagePosition.elements[2];
-    double newFlatness = newFeatures[2];
-    double newArea = newFeatures[3];
+    double newFlatness = newFeatures.convexity;
+    double newArea = newFeatures.area;
 
     //std::cout << "Diameter: " << newDiameter << "\t";
     //std::cout << "Flatness: " << newFlatness << "\t";
     //std::cout << "Area: " << newArea << "\t";
 
-    features[0].push_back(newFlatness);
-    features[1].push_back(newArea);
+    m_flatness_history.push(newFlatness);
+    m_area_history.push(newArea);
 }
 
 void HypothesesEvaluation::calculateProbabilities()
+{
+    calculateProbabilities(m_flatness_history.back(), m_area_history.back(), newProbabilities);
+}
+
+void HypothesesEvaluation::calculateProbabilities(double currentFlatness, double currentArea, double* probabilities) const
 {
     double newFlatnessProbability;
     double newAreaProbability;
 
-    vector <double> flatness = features[0];
-    vector <double> area = features[1];
-    double currentFlatness = flatness.back();
-    double currentArea = area.back();
-
     if(currentFlatness <= 0.8) {
         newFlatnessProbability = 0;
     } else {
@@ -221,8 +499,8 @@ void HypothesesEvaluation::calculateProbabilities()
     }
     double maxArea = currentArea;
     double current2MaxAreaRatio = 1;
-    if(area.size() > 1) {
-        maxArea = *std::max_element(area.begin(), area.end());
+    if(m_area_history.size() > 1) {
+        maxArea = std::max(currentArea, m_area_history.max());
         current2MaxAreaRatio = currentArea/maxArea;
     }
     if(current2MaxAreaRatio < 0.4) {
@@ -232,74 +510,110 @@ void HypothesesEvaluation::calculateProbabilities()
     }
 
 
-    newProbabilities[0] = newFlatnessProbability;
-    newProbabilities[1] = newAreaProbability;
+    probabilities[0] = newFlatnessProbability;
+    probabilities[1] = newAreaProbability;
 }
 
-void HypothesesEvaluation::updateNetwork(double* newProbabilities)
+void HypothesesEvaluation::updateNetwork(const double* newProbabilities, int frames)
 {
-    theNet.UpdateBeliefs();
-
-    double highFlatnessProbability = newProbabilities[0];
-    double highAreaProbability = newProbabilities[1];
-
-    //std::cout << " High flatness prob: " << highFlatnessProbability << "\t";
-    int ellipse = theNet.FindNode("ellipse");
-    int area = theNet.FindNode("area");
-    //int flat = theNet.FindNode("flat");
-
-    theNet.GetNode(ellipse)->Value()->ClearEvidence();
-    theNet.GetNode(area)->Value()->ClearEvidence();
+    int64 start = cv::getTickCount();
+
+    // forward filtering: belief of the previous slice, propagated by the transition
+    // model once per frame passed, enters this slice as virtual evidence on flat
+    bool temporal = false;
+    if (m_temporal) {
+        // symmetric transition raised to the power of frames: outcome is kept
+        // with probability 1/2 + 1/2 (2 p - 1)^frames
+        double persistence = m_flat_persistence;
+        double keep = 0.5 + 0.5 * std::pow(2 * persistence - 1, std::max(1, frames));
+        double predicted[2];
+        predicted[0] = keep * m_flat_belief[0] + (1 - keep) * m_flat_belief[1];
+        predicted[1] = keep * m_flat_belief[1] + (1 - keep) * m_flat_belief[0];
+        temporal = m_evaluator.applyPrediction(predicted);
+    }
 
-    DSL_doubleArray theProbs;
-    theProbs.SetSize(2);
+    m_evaluator.applyEvidence(newProbabilities);
+    if (m_evaluator.updateBeliefs()) {
+        ++m_inference_count;
+        ++m_frame_inferences;
+    }
 
-    theProbs[0] = highFlatnessProbability;
-    theProbs[1] = 1 - highFlatnessProbability;
-    theNet.GetNode(ellipse) -> Definition() -> SetDefinition(theProbs);
+    if (temporal) {
+        m_flat_belief[0] = m_evaluator.posterior(m_binding.flat, 0);
+        m_flat_belief[1] = m_evaluator.posterior(m_binding.flat, 1);
+    }
+    m_publish_complement = temporal && m_evaluator.nonflatComplementsFlat();
 
-    theProbs[0] = highAreaProbability;
-    theProbs[1] = 1 - highAreaProbability;
-    theNet.GetNode(area) -> Definition() -> SetDefinition(theProbs);
+    m_inference_ticks += cv::getTickCount() - start;
+}
 
+void HypothesesEvaluation::evaluateBatch(const Types::Blueball::BallCandidates& candidates, vector <double>& posteriors)
+{
+    int count = candidates.size();
+    posteriors.resize(2 * count);
+    if (count == 0)
+        return;
+
+    // root probabilities depend on shared history, so they are computed up front
+    m_batch_probabilities.resize(2 * count);
+    for (int i = 0; i < count; ++i) {
+        const Types::Blueball::BallFeatures& features = candidates[i].features;
+        calculateProbabilities(features.convexity, features.area, &m_batch_probabilities[2 * i]);
+    }
 
+    int threads = (m_batch_threads > 0) ? (int) m_batch_threads : cv::getNumThreads();
+    int chunks = std::max(1, std::min(threads, count));
 
-    if (highFlatnessProbability > 0.9) {
-        theNet.GetNode(ellipse)->Value()->SetEvidence(0);
+    while ((int) m_pool.size() < chunks) {
+        boost::shared_ptr<NetworkEvaluator> evaluator(new NetworkEvaluator);
+        if (!evaluator->init(theNet, m_binding, m_compiled_max_states, m_virtual_evidence)) {
+            LOG(LERROR) << "HypothesesEvaluation: can't copy network for batch evaluation\n";
+            break;
+        }
+        m_pool.push_back(evaluator);
+    }
+    chunks = std::min(chunks, (int) m_pool.size());
+    if (chunks == 0) {
+        std::fill(posteriors.begin(), posteriors.end(), 0.0);
+        return;
     }
 
+    int64 start = cv::getTickCount();
 
-    theNet.UpdateBeliefs();
-}
+    vector <int> inferences(chunks, 0);
+    EvaluateChunks body(m_pool, m_binding, m_batch_probabilities, posteriors, inferences, count, chunks);
+    if (chunks > 1) {
+        cv::parallel_for_(cv::Range(0, chunks), body, chunks);
+    } else {
+        body(cv::Range(0, 1));
+    }
 
+    for (int c = 0; c < chunks; ++c) {
+        m_inference_count += inferences[c];
+        m_frame_inferences += inferences[c];
+    }
 
-int HypothesesEvaluation::getOutcomePosition(int node, std::string outcome)
-{
-    DSL_idArray *theNames = theNet.GetNode(node)->Definition()->GetOutcomesNames();
-    return theNames->FindPosition(outcome.c_str());
+    m_inference_ticks += cv::getTickCount() - start;
 }
 
-double HypothesesEvaluation::getOutcomeProbability(int node, std::string outcome)
+double HypothesesEvaluation::getOutcomeProbability(int node, int outcome)
 {
-    DSL_sysCoordinates theFlatnessCoordinates(*theNet.GetNode(node)->Value());
-    theFlatnessCoordinates[0] = getOutcomePosition(node, outcome);
-    theFlatnessCoordinates.GoToCurrentPosition();
-    return theFlatnessCoordinates.UncheckedValue();
+    return m_evaluator.posterior(node, outcome);
 }
 
 void HypothesesEvaluation::computeDecision()
 {
     vector <double> resultingProbabilities;
 
-    int ellipse = theNet.FindNode("ellipse");
-    int area = theNet.FindNode("area");
-    int flat = theNet.FindNode("flat");
-    int nonflat = theNet.FindNode("nonflat");
-
-    double ellipseProbability = getOutcomeProbability(ellipse, "HIGH");
-    double areaProbability = getOutcomeProbability(area, "HIGH");
-    double flatProbability = getOutcomeProbability(flat, "YES");
-    double nonflatProbability = getOutcomeProbability(nonflat, "YES");
+    double ellipseProbability = getOutcomeProbability(m_binding.ellipse, m_binding.ellipse_high);
+    double areaProbability = getOutcomeProbability(m_binding.area, m_binding.area_high);
+    double flatProbability = getOutcomeProbability(m_binding.flat, m_binding.flat_yes);
+    // Prediction is virtual evidence on flat. It reaches nonflat through
+    // ellipse and area, but the likelihood of flat itself does not, so the
+    // nonflat posterior is not the complement of filtered flat. Where the
+    // network defines nonflat as "not flat", it is derived from flat.
+    double nonflatProbability = m_publish_complement ? 1 - flatProbability
+            : getOutcomeProbability(m_binding.nonflat, m_binding.nonflat_yes);
 
     displayProbability("ellipse cpt", ellipseProbability);
     displayProbability("area cpt", areaProbability);
@@ -310,13 +624,13 @@ void HypothesesEvaluation::computeDecision()
 
     resultingProbabilities.push_back(flatProbability);
     resultingProbabilities.push_back(nonflatProbability);
-    out_probabilities.write(resultingProbabilities);
+    publish(resultingProbabilities);
 
 }
 
 void HypothesesEvaluation::displayProbability(std::string message, double probability)
 {
-    std::cout << " " << message << ": " << probability << "\t";
+    LOG(LDEBUG) << "HypothesesEvaluation: " << message << ": " << probability << "\n";
 }
 
 }//: namespace Blueball
@@ -10,10 +10,26 @@
 #include "Component.hpp"
 #include "DataStream.hpp"
 
+#include "Property.hpp"
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/atomic.hpp>
+
 #include <opencv2/opencv.hpp>
 #include "../../../lib/SMILE/smile.h"
 
 #include "Types/ImagePosition.hpp"
+#include "Types/BallCandidate.hpp"
+#include "Types/BallEvaluation.hpp"
+#include "Types/SlidingWindow.hpp"
+#include "Types/Mailbox.hpp"
+
+#include "NetworkBinding.hpp"
+#include "NetworkEvaluator.hpp"
 
 namespace Processors {
 namespace Blueball {
@@ -42,17 +58,114 @@ protected:
 
     DSL_network theNet;
 
-    vector <vector <double> > features;
+    /// Network file, parsed once per process (see NetworkCache).
+    Base::Property<std::string> m_network_file;
+
+    /// Handles of theNet nodes and outcomes, resolved in initNetwork().
+    NetworkBinding m_binding;
+
+    /// Copy of theNet evaluating one hypothesis at a time.
+    NetworkEvaluator m_evaluator;
+
+    /// Copies of theNet for evaluateBatch(), one per thread.
+    std::vector<boost::shared_ptr<NetworkEvaluator> > m_pool;
+
+    /// Largest number of joint network states evaluated without SMILE, 0 to always use SMILE.
+    Base::Property<int> m_compiled_max_states;
+
+    /// Number of threads scoring candidates, 0 - as many as OpenCV uses, 1 - no parallelism.
+    Base::Property<int> m_batch_threads;
+
+    /// Pass root probabilities as virtual evidence instead of rewriting root definitions.
+    Base::Property<bool> m_virtual_evidence;
+
+    /*!
+     * Filter belief in flat from frame to frame instead of evaluating each frame alone.
+     * If the network defines nonflat as the complement of flat, published nonflat is
+     * 1 - filtered flat, otherwise it is the nonflat posterior. Only frames evaluated
+     * one at a time are filtered - batched in_candidates scoring ignores this setting.
+     */
+    Base::Property<bool> m_temporal;
+
+    /// Probability that flat keeps its outcome from one frame to the next.
+    Base::Property<double> m_flat_persistence;
+
+    /// Filtered belief in flat after the previous frame, indexed by outcome.
+    double m_flat_belief[2];
+
+    /// Set when the last update filtered flat and nonflat is its complement, see computeDecision().
+    bool m_publish_complement;
+
+    /// Recent flatness and area values, with running maximum.
+    Types::Blueball::SlidingWindow m_flatness_history;
+    Types::Blueball::SlidingWindow m_area_history;
+
+    /// Number of frames kept in feature history.
+    Base::Property<int> m_history_window;
 
     double newProbabilities[2];
 
+    /// Root probabilities of each candidate scored by evaluateBatch().
+    vector <double> m_batch_probabilities;
+
+    /// Number of belief updates in total and in the frame being processed.
+    unsigned long m_inference_count;
+    int m_frame_inferences;
+
+    /// Number of frames over which inference time is averaged and logged, 0 - no timing log.
+    Base::Property<int> m_timing_frames;
+
+    /// Ticks spent on evidence and inference since the last timing log, and frames they cover.
+    int64 m_inference_ticks;
+    int m_timed_frames;
+
+    /// Frame id and timestamp of the features being evaluated.
+    int m_frame_id;
+    int64 m_timestamp;
+
+    /// Evaluate in_features on a separate thread, only the newest frame is evaluated when it falls behind.
+    Base::Property<bool> m_async;
+
+    /// Root probabilities of one frame, passed to the inference thread.
+    struct InferenceRequest
+    {
+        double probabilities[2];
+        int frame_id;
+        int64 timestamp;
+
+        /// Number of the frame, counted by onNewImage.
+        unsigned long sequence;
+    };
+
+    /// Newest request for the inference thread.
+    Types::Blueball::Mailbox<InferenceRequest> m_mailbox;
+
+    /// Sequence of the last posted request (onNewImage) and of the last evaluated one (inference thread).
+    unsigned long m_posted;
+    unsigned long m_taken;
+
+    /// Inference thread and its wake-up signal.
+    boost::scoped_ptr<boost::thread> m_worker;
+    boost::atomic<bool> m_worker_running;
+    boost::mutex m_wakeup_mutex;
+    boost::condition_variable m_wakeup;
+
     // Input data stream
     //Base::DataStreamIn <Types::ImagePosition> in_imagePosition;
     //Base::DataStreamIn <Mat> in_img;
-    Base::DataStreamIn < vector <double> > in_features;
+    Base::DataStreamIn <Types::Blueball::BallFeatures> in_features;
+
+    /// Alternative input - all candidates of a frame, scored in one step
+    Base::DataStreamIn <Types::Blueball::BallCandidates> in_candidates;
 
     // Output data stream
     Base::DataStreamOut < vector <double> > out_probabilities;
+
+    /// Probabilities with the frame they belong to.
+    Base::DataStreamOut <Types::Blueball::BallEvaluation> out_evaluation;
+
+    /// Number of belief updates done for the last frame.
+    Base::DataStreamOut <int> out_inferences;
     //Base::DataStreamOut <Mat> out_img;
 
     // Event handler function.
@@ -61,6 +174,11 @@ protected:
     // Event handler.
     Base::EventHandler <HypothesesEvaluation> h_onNewImage;
 
+    // Scores all candidates, flat/nonflat probabilities of each are written in turn.
+    void onCandidates();
+
+    Base::EventHandler <HypothesesEvaluation> h_onCandidates;
+
     // Event emited after the image is processed.
     //Base::Event * newImage;
 
@@ -96,15 +214,43 @@ private:
 
     void createNetwork();
 
-    void updateFeatureVector(const std::vector<double> newFeatures);
+    void updateFeatureVector(const Types::Blueball::BallFeatures& newFeatures);
 
     void calculateProbabilities();
+    void calculateProbabilities(double currentFlatness, double currentArea, double* probabilities) const;
+
+    /*!
+     * Applies evidence and updates beliefs. In temporal mode flat belief
+     * is first predicted over \p frames frames since the previous update.
+     */
+    void updateNetwork(const double* newProbabilities, int frames);
+
+    /*!
+     * Scores all candidates, in parallel on copies of the network.
+     * \param posteriors flat and nonflat probability of each candidate in turn
+     */
+    void evaluateBatch(const Types::Blueball::BallCandidates& candidates, vector <double>& posteriors);
+
+    void beginFrame();
+    void endFrame();
+
+    /// Evaluates features of one frame in onNewImage.
+    void evaluate(const Types::Blueball::BallFeatures& features);
+
+    /// Updates network with root probabilities of one frame and publishes result, \p frames passed since the last one.
+    void infer(const double* probabilities, int frames);
+
+    /// Publishes probabilities to out_probabilities and out_evaluation.
+    void publish(const vector <double>& probabilities);
 
-    void updateNetwork(double* newProbabilities);
+    void startWorker();
+    void stopWorker();
 
-    int getOutcomePosition(int node, std::string outcome);
+    /// Body of the inference thread, evaluates the newest posted frame.
+    void inferenceLoop();
 
-    double getOutcomeProbability(int node, std::string outcome);
+    /// Posterior of an outcome from the active backend.
+    double getOutcomeProbability(int node, int outcome);
 
     void computeDecision();
 
@@ -0,0 +1,91 @@
+/*!
+ * \file NetworkBinding.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include "NetworkBinding.hpp"
+
+#include "Common/Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+namespace {
+
+/// Handle of the named node, -1 (logged) if absent.
+int findNode(DSL_network& net, const char* name)
+{
+    int node = net.FindNode(name);
+    if (node < 0)
+        LOG(LERROR) << "Network has no node " << name << "\n";
+    return node;
+}
+
+/// Index of the named outcome of given node, -1 (logged) if absent.
+int findOutcome(DSL_network& net, int node, const char* outcome)
+{
+    if (node < 0)
+        return -1;
+    int position = net.GetNode(node)->Definition()->GetOutcomesNames()->FindPosition(outcome);
+    if (position < 0)
+        LOG(LERROR) << "Node " << net.GetNode(node)->GetId() << " has no outcome " << outcome << "\n";
+    return position;
+}
+
+/// Checks (and logs) that the node is binary, outcome indices are then 0 and 1.
+bool isBinary(DSL_network& net, int node)
+{
+    if (node < 0)
+        return false;
+    int outcomes = net.GetNode(node)->Definition()->GetNumberOfOutcomes();
+    if (outcomes != 2)
+        LOG(LERROR) << "Node " << net.GetNode(node)->GetId() << " has " << outcomes << " outcomes, 2 expected\n";
+    return outcomes == 2;
+}
+
+/// Checks (and logs) that the node has no parents, so its prior is its whole definition.
+bool isRoot(DSL_network& net, int node)
+{
+    if (node < 0)
+        return false;
+    int parents = net.GetParents(node).NumItems();
+    if (parents != 0)
+        LOG(LERROR) << "Node " << net.GetNode(node)->GetId() << " has " << parents << " parents, evidence node must be a root\n";
+    return parents == 0;
+}
+
+}//: namespace
+
+NetworkBinding::NetworkBinding() :
+    ellipse(-1), area(-1), flat(-1), nonflat(-1),
+    ellipse_high(-1), area_high(-1), flat_yes(-1), nonflat_yes(-1),
+    valid(false)
+{
+}
+
+bool NetworkBinding::bind(DSL_network& net)
+{
+    ellipse = findNode(net, "ellipse");
+    area = findNode(net, "area");
+    flat = findNode(net, "flat");
+    nonflat = findNode(net, "nonflat");
+
+    ellipse_high = findOutcome(net, ellipse, "HIGH");
+    area_high = findOutcome(net, area, "HIGH");
+    flat_yes = findOutcome(net, flat, "YES");
+    nonflat_yes = findOutcome(net, nonflat, "YES");
+
+    // evaluation writes two-element evidence vectors to the roots and
+    // reads two-element beliefs, anything else would index out of bounds;
+    // every check runs, so that all problems get logged
+    bool shape = isBinary(net, ellipse) & isBinary(net, area) & isBinary(net, flat) & isBinary(net, nonflat)
+            & isRoot(net, ellipse) & isRoot(net, area);
+
+    valid = shape && ellipse_high >= 0 && area_high >= 0 && flat_yes >= 0 && nonflat_yes >= 0;
+    return valid;
+}
+
+}//: namespace Blueball
+}//: namespace Processors
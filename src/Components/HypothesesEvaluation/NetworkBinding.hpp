@@ -0,0 +1,63 @@
+/*!
+ * \file NetworkBinding.hpp
+ * \brief Node handles and outcome indices of the ball network.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef NETWORK_BINDING_HPP_
+#define NETWORK_BINDING_HPP_
+
+#include "../../../lib/SMILE/smile.h"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \struct NetworkBinding
+ * \brief Everything evaluation needs from the network, resolved once by name.
+ *
+ * After bind() succeeded, evidence and posteriors are accessed by handle
+ * and outcome index only, with no string lookups per frame.
+ */
+struct NetworkBinding
+{
+    NetworkBinding();
+
+    /*!
+     * Resolves nodes and outcomes of the given network. All four nodes
+     * must have exactly two outcomes, ellipse and area must have no parents.
+     * \returns false (and logs the reason) if any of them is missing or
+     * has different shape.
+     */
+    bool bind(DSL_network& net);
+
+    /// Node handles.
+    int ellipse;
+    int area;
+    int flat;
+    int nonflat;
+
+    /// Outcome indices.
+    int ellipse_high;
+    int area_high;
+    int flat_yes;
+    int nonflat_yes;
+
+    /// True after successful bind().
+    bool valid;
+};
+
+/*!
+ * Posterior probability of the given outcome, read directly from node value.
+ * Beliefs must be up to date.
+ */
+inline double posterior(DSL_network& net, int node, int outcome)
+{
+    return (*net.GetNode(node)->Value()->GetMatrix())[outcome];
+}
+
+}//: namespace Blueball
+}//: namespace Processors
+
+#endif /* NETWORK_BINDING_HPP_ */
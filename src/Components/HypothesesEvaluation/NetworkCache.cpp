@@ -0,0 +1,73 @@
+/*!
+ * \file NetworkCache.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include "NetworkCache.hpp"
+
+#include <map>
+#include <sys/stat.h>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "Common/Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+namespace {
+
+struct CachedNetwork
+{
+    time_t mtime;
+    boost::shared_ptr<DSL_network> net;
+};
+
+typedef std::map<std::string, CachedNetwork> NetworkMap;
+
+NetworkMap& networks()
+{
+    static NetworkMap map;
+    return map;
+}
+
+boost::mutex& networksMutex()
+{
+    static boost::mutex mutex;
+    return mutex;
+}
+
+}//: namespace
+
+int NetworkCache::load(const std::string& path, DSL_network& net)
+{
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        LOG(LERROR) << "NetworkCache: can't access " << path << "\n";
+        return DSL_FILE_READ;
+    }
+
+    boost::mutex::scoped_lock lock(networksMutex());
+
+    CachedNetwork& cached = networks()[path];
+    if (!cached.net || cached.mtime != info.st_mtime) {
+        boost::shared_ptr<DSL_network> parsed(new DSL_network);
+        int result = parsed->ReadFile(path.c_str(), DSL_XDSL_FORMAT);
+        if (result != DSL_OKAY) {
+            LOG(LERROR) << "NetworkCache: reading " << path << " failed: " << result << "\n";
+            networks().erase(path);
+            return result;
+        }
+        LOG(LINFO) << "NetworkCache: parsed " << path << "\n";
+        cached.mtime = info.st_mtime;
+        cached.net = parsed;
+    }
+
+    return net.FastCopy(*cached.net);
+}
+
+}//: namespace Blueball
+}//: namespace Processors
@@ -0,0 +1,40 @@
+/*!
+ * \file NetworkCache.hpp
+ * \brief Networks parsed once per process and copied to each evaluator.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef NETWORK_CACHE_HPP_
+#define NETWORK_CACHE_HPP_
+
+#include <string>
+
+#include "../../../lib/SMILE/smile.h"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class NetworkCache
+ * \brief Process-wide cache of parsed network files.
+ *
+ * Each file is parsed once and kept as a template, keyed by path and
+ * modification time; evaluators get a DSL_network::FastCopy of it.
+ * A file modified on disk is parsed again on next load. Safe to use
+ * from components running in different executors.
+ */
+class NetworkCache
+{
+public:
+    /*!
+     * Replaces contents of net with the network stored in given file.
+     * \returns DSL_OKAY, or SMILE error code of reading or copying.
+     */
+    static int load(const std::string& path, DSL_network& net);
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+#endif /* NETWORK_CACHE_HPP_ */
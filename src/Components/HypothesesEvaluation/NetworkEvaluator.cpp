@@ -0,0 +1,225 @@
+/*!
+ * \file NetworkEvaluator.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <cmath>
+
+#include "NetworkEvaluator.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+NetworkEvaluator::NetworkEvaluator() :
+    m_virtual_evidence(false),
+    m_temporal_ready(false),
+    m_nonflat_complement(false),
+    m_belief_state(BeliefsStale),
+    m_applied_observation(false)
+{
+    m_applied_probabilities[0] = m_applied_probabilities[1] = -1;
+    m_flat_prior[0] = m_flat_prior[1] = 0.5;
+}
+
+bool NetworkEvaluator::init(DSL_network& source, const NetworkBinding& binding, int compiled_max_states, bool virtual_evidence)
+{
+    if (m_net.FastCopy(source) != DSL_OKAY)
+        return false;
+
+    m_binding = binding;
+    m_net.SetDefaultBNAlgorithm(DSL_ALG_BN_LAURITZEN);
+    m_net.ClearAllEvidence();
+    m_compiled.compile(m_net, compiled_max_states);
+
+    m_virtual_evidence = virtual_evidence
+            && readPrior(m_binding.ellipse, m_ellipse_prior)
+            && readPrior(m_binding.area, m_area_prior);
+
+    m_temporal_ready = false;
+    if (m_net.GetNode(m_binding.flat)->Definition()->GetNumberOfOutcomes() == 2) {
+        m_belief_state = BeliefsStale;
+        updateBeliefs();
+        m_flat_prior[0] = posterior(m_binding.flat, 0);
+        m_flat_prior[1] = posterior(m_binding.flat, 1);
+        m_temporal_ready = m_flat_prior[0] > 0 && m_flat_prior[1] > 0;
+    }
+    m_nonflat_complement = readComplement();
+
+    m_belief_state = BeliefsStale;
+    m_applied_probabilities[0] = m_applied_probabilities[1] = -1;
+    m_applied_observation = false;
+    return true;
+}
+
+bool NetworkEvaluator::readPrior(int node, double* prior)
+{
+    if (m_net.GetParents(node).NumItems() != 0)
+        return false;
+
+    DSL_Dmatrix* cpt = NULL;
+    m_net.GetNode(node)->Definition()->GetDefinition(&cpt);
+    if (cpt == NULL || cpt->GetSize() != 2)
+        return false;
+
+    prior[0] = (*cpt)[0];
+    prior[1] = (*cpt)[1];
+    return prior[0] > 0 && prior[1] > 0;
+}
+
+bool NetworkEvaluator::readComplement()
+{
+    int flat = m_binding.flat;
+    int nonflat = m_binding.nonflat;
+
+    const DSL_intArray& flat_parents = m_net.GetParents(flat);
+    const DSL_intArray& nonflat_parents = m_net.GetParents(nonflat);
+    if (flat_parents.NumItems() != nonflat_parents.NumItems())
+        return false;
+    for (int i = 0; i < flat_parents.NumItems(); ++i) {
+        if (flat_parents[i] != nonflat_parents[i])
+            return false;
+    }
+
+    DSL_Dmatrix* flat_cpt = NULL;
+    DSL_Dmatrix* nonflat_cpt = NULL;
+    m_net.GetNode(flat)->Definition()->GetDefinition(&flat_cpt);
+    m_net.GetNode(nonflat)->Definition()->GetDefinition(&nonflat_cpt);
+    if (flat_cpt == NULL || nonflat_cpt == NULL || flat_cpt->GetSize() != nonflat_cpt->GetSize())
+        return false;
+
+    // both binary (see NetworkBinding::bind), outcomes vary fastest
+    for (int i = 0; i + 1 < flat_cpt->GetSize(); i += 2) {
+        double flat_yes = (*flat_cpt)[i + m_binding.flat_yes];
+        double nonflat_yes = (*nonflat_cpt)[i + m_binding.nonflat_yes];
+        if (std::fabs(flat_yes + nonflat_yes - 1) > 1e-9)
+            return false;
+    }
+    return true;
+}
+
+void NetworkEvaluator::setLikelihood(int node, const double* prior, const double* probabilities)
+{
+    // posterior ~ prior * likelihood, normalized so that SMILE accepts it
+    double likelihoods[2];
+    likelihoods[0] = probabilities[0] / prior[0];
+    likelihoods[1] = probabilities[1] / prior[1];
+    double sum = likelihoods[0] + likelihoods[1];
+    likelihoods[0] /= sum;
+    likelihoods[1] /= sum;
+
+    if (m_compiled.ready()) {
+        m_compiled.setLikelihood(node, likelihoods);
+    } else {
+        m_likelihoods.assign(likelihoods, likelihoods + 2);
+        m_net.GetNode(node)->Value()->ClearEvidence();
+        m_net.GetNode(node)->Value()->SetVirtualEvidence(m_likelihoods);
+    }
+}
+
+void NetworkEvaluator::applyEvidence(const double* probabilities)
+{
+    double highFlatnessProbability = probabilities[0];
+    double highAreaProbability = probabilities[1];
+    bool observed = highFlatnessProbability > 0.9;
+
+    int ellipse = m_binding.ellipse;
+    int area = m_binding.area;
+
+    double ellipseProbs[2];
+    ellipseProbs[m_binding.ellipse_high] = highFlatnessProbability;
+    ellipseProbs[1 - m_binding.ellipse_high] = 1 - highFlatnessProbability;
+
+    double areaProbs[2];
+    areaProbs[m_binding.area_high] = highAreaProbability;
+    areaProbs[1 - m_binding.area_high] = 1 - highAreaProbability;
+
+    bool ellipseChanged = highFlatnessProbability != m_applied_probabilities[0];
+    bool areaChanged = highAreaProbability != m_applied_probabilities[1];
+    bool observationChanged = observed != m_applied_observation;
+
+    if (m_virtual_evidence) {
+        if (areaChanged)
+            setLikelihood(area, m_area_prior, areaProbs);
+
+        // observation replaces virtual evidence on ellipse
+        if (observed && observationChanged) {
+            if (m_compiled.ready()) {
+                m_compiled.setEvidence(ellipse, m_binding.ellipse_high);
+            } else {
+                m_net.GetNode(ellipse)->Value()->ClearEvidence();
+                m_net.GetNode(ellipse)->Value()->SetEvidence(m_binding.ellipse_high);
+            }
+        } else if (!observed && (ellipseChanged || observationChanged)) {
+            setLikelihood(ellipse, m_ellipse_prior, ellipseProbs);
+        }
+    } else if (m_compiled.ready()) {
+        if (ellipseChanged)
+            m_compiled.setPrior(ellipse, ellipseProbs);
+        if (areaChanged)
+            m_compiled.setPrior(area, areaProbs);
+        if (observationChanged) {
+            if (observed)
+                m_compiled.setEvidence(ellipse, m_binding.ellipse_high);
+            else
+                m_compiled.clearEvidence(ellipse);
+        }
+    } else {
+        DSL_doubleArray theProbs;
+        theProbs.SetSize(2);
+
+        if (ellipseChanged) {
+            theProbs[0] = ellipseProbs[0];
+            theProbs[1] = ellipseProbs[1];
+            m_net.GetNode(ellipse) -> Definition() -> SetDefinition(theProbs);
+        }
+
+        if (areaChanged) {
+            theProbs[0] = areaProbs[0];
+            theProbs[1] = areaProbs[1];
+            m_net.GetNode(area) -> Definition() -> SetDefinition(theProbs);
+        }
+
+        // observation is re-applied on top of a new definition
+        if (observationChanged || (observed && ellipseChanged)) {
+            m_net.GetNode(ellipse)->Value()->ClearEvidence();
+            if (observed)
+                m_net.GetNode(ellipse)->Value()->SetEvidence(m_binding.ellipse_high);
+        }
+    }
+
+    if (ellipseChanged || areaChanged || observationChanged)
+        m_belief_state = BeliefsStale;
+
+    m_applied_probabilities[0] = highFlatnessProbability;
+    m_applied_probabilities[1] = highAreaProbability;
+    m_applied_observation = observed;
+}
+
+bool NetworkEvaluator::applyPrediction(const double* predicted)
+{
+    if (!m_temporal_ready)
+        return false;
+
+    setLikelihood(m_binding.flat, m_flat_prior, predicted);
+    m_belief_state = BeliefsStale;
+    return true;
+}
+
+bool NetworkEvaluator::updateBeliefs()
+{
+    if (m_belief_state == BeliefsCurrent)
+        return false;
+
+    if (m_compiled.ready())
+        m_compiled.update();
+    else
+        m_net.UpdateBeliefs();
+
+    m_belief_state = BeliefsCurrent;
+    return true;
+}
+
+}//: namespace Blueball
+}//: namespace Processors
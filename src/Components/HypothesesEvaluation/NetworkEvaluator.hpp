@@ -0,0 +1,160 @@
+/*!
+ * \file NetworkEvaluator.hpp
+ * \brief Private copy of the ball network with its own evidence and beliefs.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef NETWORK_EVALUATOR_HPP_
+#define NETWORK_EVALUATOR_HPP_
+
+#include <vector>
+
+#include "../../../lib/SMILE/smile.h"
+
+#include "NetworkBinding.hpp"
+#include "CompiledNetwork.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class NetworkEvaluator
+ * \brief Evaluates hypotheses on its own copy of a network.
+ *
+ * Root probabilities and the ellipse observation are passed to the network
+ * only when they change, and beliefs are updated only when stale. Small
+ * networks are evaluated by CompiledNetwork, others by SMILE. Separate
+ * evaluators share no state, so each may be used by a different thread.
+ *
+ * Root probabilities are given either as new root definitions, or as
+ * virtual evidence on roots with fixed definitions. Likelihoods are the
+ * requested probabilities divided by the prior, so both give the same
+ * posteriors, but virtual evidence does not make SMILE rebuild the
+ * junction tree.
+ */
+class NetworkEvaluator
+{
+public:
+    NetworkEvaluator();
+
+    /*!
+     * Copies the network, resets evidence and compiles it if possible.
+     * \param compiled_max_states largest number of joint states evaluated without SMILE
+     * \param virtual_evidence pass root probabilities as virtual evidence,
+     * ignored (definitions are used) if a root has parents or a zero prior
+     * \returns false if the network could not be copied.
+     */
+    bool init(DSL_network& source, const NetworkBinding& binding, int compiled_max_states, bool virtual_evidence);
+
+    /// True if CompiledNetwork is used instead of SMILE.
+    bool compiled() const
+    {
+        return m_compiled.ready();
+    }
+
+    const CompiledNetwork& compiledNetwork() const
+    {
+        return m_compiled;
+    }
+
+    /// True if root probabilities are passed as virtual evidence.
+    bool virtualEvidence() const
+    {
+        return m_virtual_evidence;
+    }
+
+    /*!
+     * Passes changed root probabilities to the network.
+     * \param probabilities high ellipse and high area probability
+     */
+    void applyEvidence(const double* probabilities);
+
+    /// Marginal of flat with no evidence, indexed by outcome.
+    const double* flatPrior() const
+    {
+        return m_flat_prior;
+    }
+
+    /*!
+     * Sets belief in flat predicted from the previous frame. It is applied
+     * as virtual evidence on flat (prediction divided by flatPrior()), so
+     * the next update gives the filtered belief.
+     * \returns false if flat is not binary or has an impossible outcome.
+     */
+    bool applyPrediction(const double* predicted);
+
+    /*!
+     * True if nonflat has the parents of flat and its CPT gives the yes
+     * outcome exactly where flat gives no, i.e. nonflat stands for "not flat".
+     */
+    bool nonflatComplementsFlat() const
+    {
+        return m_nonflat_complement;
+    }
+
+    /*!
+     * Runs inference if evidence changed since the last one.
+     * \returns true if inference was run.
+     */
+    bool updateBeliefs();
+
+    /// Posterior of an outcome, beliefs must be up to date.
+    double posterior(int node, int outcome)
+    {
+        if (m_compiled.ready())
+            return m_compiled.posterior(node, outcome);
+        return Blueball::posterior(m_net, node, outcome);
+    }
+
+private:
+    NetworkEvaluator(const NetworkEvaluator&);
+    NetworkEvaluator& operator=(const NetworkEvaluator&);
+
+    /// Reads prior of a binary root, false if node is not one or any outcome is impossible.
+    bool readPrior(int node, double* prior);
+
+    /// Checks whether flat and nonflat share parents and have complementary CPTs.
+    bool readComplement();
+
+    /// Sets likelihoods of a root making its posterior equal to probabilities.
+    void setLikelihood(int node, const double* prior, const double* probabilities);
+
+    DSL_network m_net;
+    NetworkBinding m_binding;
+
+    /// Closed-form copy of m_net, used instead of SMILE when ready.
+    CompiledNetwork m_compiled;
+
+    /// Root probabilities passed as virtual evidence, priors of roots from the network file.
+    bool m_virtual_evidence;
+    double m_ellipse_prior[2];
+    double m_area_prior[2];
+
+    /// Marginal of flat before any evidence, valid if m_temporal_ready.
+    double m_flat_prior[2];
+    bool m_temporal_ready;
+
+    /// See nonflatComplementsFlat().
+    bool m_nonflat_complement;
+
+    /// Likelihoods passed to SMILE.
+    std::vector<double> m_likelihoods;
+
+    /// Whether beliefs reflect the evidence applied to the network.
+    enum BeliefState {
+        BeliefsStale,
+        BeliefsCurrent
+    };
+
+    BeliefState m_belief_state;
+
+    /// Root probabilities and ellipse observation applied last, only changes are passed to the network.
+    double m_applied_probabilities[2];
+    bool m_applied_observation;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+#endif /* NETWORK_EVALUATOR_HPP_ */
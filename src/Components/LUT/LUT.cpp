@@ -5,6 +5,7 @@
  * \date 2010-07-05
  */
 
+#include <algorithm>
 #include <memory>
 #include <string>
 
@@ -17,11 +18,67 @@ namespace Blueball {
 // OpenCV writes hue in range 0..180 instead of 0..360
 #define H(x) (x>>1)
 
+namespace {
+
+/*!
+ * Labels rows [row_begin, row_end) of the HSV image.
+ */
+void segmentRows(const Types::Blueball::HSVSegmenter& segmenter, const cv::Mat& hsv_img, cv::Mat& segments, int row_begin, int row_end)
+{
+    // Check the arrays for continuity and, if this is the case,
+    // treat the rows as one 1D vector
+    if (hsv_img.isContinuous() && segments.isContinuous()) {
+        segmenter.segmentRow(hsv_img.ptr <uchar> (row_begin), segments.ptr <uchar> (row_begin),
+                hsv_img.cols * (row_end - row_begin));
+        return;
+    }
+
+    for (int i = row_begin; i < row_end; i++) {
+        segmenter.segmentRow(hsv_img.ptr <uchar> (i), segments.ptr <uchar> (i), hsv_img.cols);
+    }
+}
+
+/*!
+ * Splits image into equal stripes of rows, each stripe is labeled as a separate task.
+ */
+class SegmentStripes: public cv::ParallelLoopBody
+{
+public:
+    SegmentStripes(const Types::Blueball::HSVSegmenter& segmenter, const cv::Mat& hsv_img, cv::Mat& segments, int stripes) :
+        m_segmenter(segmenter), m_hsv_img(hsv_img), m_segments(segments), m_stripes(stripes)
+    {
+    }
+
+    void operator()(const cv::Range& range) const
+    {
+        int rows = m_hsv_img.rows;
+        int row_begin = (int) ((int64) range.start * rows / m_stripes);
+        int row_end = (int) ((int64) range.end * rows / m_stripes);
+        segmentRows(m_segmenter, m_hsv_img, m_segments, row_begin, row_end);
+    }
+
+private:
+    const Types::Blueball::HSVSegmenter& m_segmenter;
+    const cv::Mat& m_hsv_img;
+    cv::Mat& m_segments;
+    int m_stripes;
+};
+
+}
+
 LUT::LUT(const std::string & name) : Base::Component(name),
     m_hue_threshold_1("hue_thr_1", 180, "range"),
     m_hue_threshold_2("hue_thr_2", 240, "range"),
     m_sat_threshold_1("sat_thr_1", 100, "range"),
-    m_val_threshold_1("val_thr_1", 100, "range")
+    m_val_threshold_1("val_thr_1", 100, "range"),
+    m_kernel("kernel", std::string("auto"), "combo"),
+    m_extra_regions("extra_regions", std::string("")),
+    m_threads("threads", 1, "range"),
+    m_min_stripe_rows("min_stripe_rows", 64, "range"),
+    m_buffers("buffers", 3, "range"),
+    m_produce_hue("produce_hue", false),
+    m_produce_packed("produce_packed", false),
+    m_produce_runs("produce_runs", false)
 {
     m_hue_threshold_1.addConstraint("0");
     m_hue_threshold_1.addConstraint("360");
@@ -41,6 +98,29 @@ LUT::LUT(const std::string & name) : Base::Component(name),
     registerProperty(m_sat_threshold_1);
     registerProperty(m_val_threshold_1);
 
+    m_kernel.addConstraint("auto");
+    m_kernel.addConstraint("scalar");
+    m_kernel.addConstraint("sse4");
+    m_kernel.addConstraint("avx2");
+    m_kernel.addConstraint("table");
+    registerProperty(m_kernel);
+    registerProperty(m_extra_regions);
+
+    m_threads.addConstraint("0");
+    m_threads.addConstraint("64");
+    registerProperty(m_threads);
+
+    m_min_stripe_rows.addConstraint("1");
+    m_min_stripe_rows.addConstraint("4096");
+    registerProperty(m_min_stripe_rows);
+
+    m_buffers.addConstraint("1");
+    m_buffers.addConstraint("16");
+    registerProperty(m_buffers);
+    registerProperty(m_produce_hue);
+    registerProperty(m_produce_packed);
+    registerProperty(m_produce_runs);
+
     LOG(LTRACE) << "Hello LUT\n";
 }
 
@@ -60,8 +140,13 @@ void LUT::prepareInterface()
     registerStream("in_img", &in_img);
     addDependency("onNewImage", &in_img);
 
+    // region of interest is optional, last received one is used
+    registerStream("in_roi", &in_roi);
+
     registerStream("out_hue", &out_hue);
     registerStream("out_segments", &out_segments);
+    registerStream("out_packed", &out_packed);
+    registerStream("out_runs", &out_runs);
 
 }
 
@@ -99,56 +184,66 @@ void LUT::onNewImage()
     try {
         cv::Mat hsv_img = in_img.read();
 
+        if (in_roi.fresh())
+            m_roi = in_roi.read();
+
         cv::Size size = hsv_img.size();
+        cv::Rect roi = Types::Blueball::clampRoi(m_roi, size);
+
+        m_segments_pool.setCapacity(m_buffers);
+        cv::Mat segments = m_segments_pool.get(size, CV_8UC1);
+
+        if (m_segmenter.setKernel(m_kernel))
+            LOG(LINFO) << "LUT: using " << m_segmenter.kernel() << " segmentation kernel\n";
+
+        Types::Blueball::HSVThresholds thr = Types::Blueball::makeThresholds(H(m_hue_threshold_1), H(m_hue_threshold_2),
+                m_sat_threshold_1, m_val_threshold_1);
+        if (int failed = m_segmenter.setThresholds(thr, m_extra_regions))
+            LOG(LWARNING) << "LUT: " << failed << " of extra regions ignored\n";
+
+        // Only the region of interest is segmented, rest of the mask is cleared
+        cv::Mat hsv_roi = hsv_img;
+        cv::Mat seg_roi = segments;
+        if (roi.size() != size) {
+            Types::Blueball::clearOutside(segments, roi);
+            hsv_roi = hsv_img(roi);
+            seg_roi = segments(roi);
+        }
 
-        hue_img.create(size, CV_8UC1);
-        segments.create(size, CV_8UC1);
+        // Small frames stay single-threaded, so that each stripe
+        // is worth scheduling.
+        int threads = (m_threads > 0) ? (int) m_threads : cv::getNumThreads();
+        int stripes = std::min(threads, roi.height / std::max(1, (int) m_min_stripe_rows));
+
+        if (stripes > 1) {
+            cv::parallel_for_(cv::Range(0, stripes), SegmentStripes(m_segmenter, hsv_roi, seg_roi, stripes), stripes);
+        } else {
+            segmentRows(m_segmenter, hsv_roi, seg_roi, 0, roi.height);
+        }
 
-        // Check the arrays for continuity and, if this is the case,
-        // treat the arrays as 1D vectors
-        if (hsv_img.isContinuous() && segments.isContinuous() && hue_img.isContinuous()) {
-            size.width *= size.height;
-            size.height = 1;
+        if (m_produce_hue) {
+            m_hue_pool.setCapacity(m_buffers);
+            cv::Mat hue_img = m_hue_pool.get(size, CV_8UC1);
+            int from_to[] = { 0, 0 };
+            cv::mixChannels(&hsv_img, 1, &hue_img, 1, from_to, 1);
+            out_hue.write(hue_img);
         }
-        size.width *= 3;
-
-        for (int i = 0; i < size.height; i++) {
-            // when the arrays are continuous,
-            // the outer loop is executed only once
-            // if not - it's executed for each row
-            const uchar* hsv_p = hsv_img.ptr <uchar> (i);
-            uchar* seg_p = segments.ptr <uchar> (i);
-            uchar* hue_p = hue_img.ptr <uchar> (i);
-
-            int j, k = 0;
-            for (j = 0; j < size.width; j += 3) {
-                uchar hue = hsv_p[j];
-                uchar sat = hsv_p[j + 1];
-                uchar val = hsv_p[j + 2];
-
-                // label colors
-                if (hue < H(m_hue_threshold_1))
-                    hue = 0;
-                else if (hue < H(m_hue_threshold_2))
-                    hue = 255; //blue
-                else
-                    hue = 0;
-
-                // exclude undersaturated areas (gray levels)
-                if (sat < m_sat_threshold_1)
-                    hue = 0;
-
-                // exclude too dark areas
-                if ((val < m_val_threshold_1))
-                    hue = 0;
-
-                seg_p[k] = hue;
-
-                ++k;
-            }
+
+        if (m_produce_packed) {
+            m_packed_pool.setCapacity(m_buffers);
+            Types::Blueball::BitMask packed;
+            packed.assign(m_packed_pool.get(Types::Blueball::BitMask::bufferSize(size), CV_8UC1), size.width);
+            Types::Blueball::pack(segments, packed);
+            out_packed.write(packed);
+        }
+
+        if (m_produce_runs) {
+            m_runs_pool.setCapacity(m_buffers);
+            Types::Blueball::SharedPool<Types::Blueball::RunMask>::Pointer runs = m_runs_pool.get();
+            Types::Blueball::encodeRuns(segments, roi, *runs);
+            out_runs.write(runs);
         }
 
-        out_hue.write(hue_img);
         out_segments.write(segments);
 
     }
@@ -17,6 +17,13 @@
 #include <opencv2/opencv.hpp>
 #include <highgui.h>
 
+#include "Types/HSVSegmenter.hpp"
+#include "Types/MatPool.hpp"
+#include "Types/SearchWindow.hpp"
+#include "Types/BitMask.hpp"
+#include "Types/Runs.hpp"
+#include "Types/SharedPool.hpp"
+
 namespace Processors {
 namespace Blueball {
 
@@ -81,20 +88,61 @@ protected:
     /// Input image
     Base::DataStreamIn <Mat> in_img;
 
+    /// Optional input - region to segment, empty rectangle means whole image
+    Base::DataStreamIn <cv::Rect> in_roi;
+
     /// Output data stream - hue part with continous red
     Base::DataStreamOut <Mat> out_hue;
 
     /// Output data stream - segments
     Base::DataStreamOut <Mat> out_segments;
 
+    /// Output data stream - segments packed to one bit per pixel
+    Base::DataStreamOut <Types::Blueball::BitMask> out_packed;
+
+    /// Output data stream - runs of segmented pixels, only the region of interest is scanned
+    Base::DataStreamOut <Types::Blueball::SharedRunMask> out_runs;
+
 private:
-    cv::Mat hue_img;
-    cv::Mat segments;
+    /// Last region received from in_roi.
+    cv::Rect m_roi;
+
+    /// Output buffers, recycled once downstream components release them.
+    Types::Blueball::MatPool m_hue_pool;
+    Types::Blueball::MatPool m_segments_pool;
+    Types::Blueball::SharedPool<Types::Blueball::RunMask> m_runs_pool;
+    Types::Blueball::MatPool m_packed_pool;
 
     Base::Property<int> m_hue_threshold_1;
     Base::Property<int> m_hue_threshold_2;
     Base::Property<int> m_sat_threshold_1;
     Base::Property<int> m_val_threshold_1;
+
+    /// Segmentation kernel: auto, scalar, sse4, avx2 or table.
+    Base::Property<std::string> m_kernel;
+
+    /// Additional "hue_1:hue_2:sat:val" boxes labeled in table mode, separated by ';'.
+    Base::Property<std::string> m_extra_regions;
+
+    /// Number of threads segmenting image stripes, 0 - as many as OpenCV uses, 1 - no parallelism.
+    Base::Property<int> m_threads;
+
+    /// Minimal height of a stripe processed by one thread.
+    Base::Property<int> m_min_stripe_rows;
+
+    /// Number of buffers kept for each output stream.
+    Base::Property<int> m_buffers;
+
+    /// Whether hue image is written to out_hue, disable when it has no sinks.
+    Base::Property<bool> m_produce_hue;
+
+    /// Whether bit-packed mask is written to out_packed.
+    Base::Property<bool> m_produce_packed;
+
+    /// Whether run-length encoded mask is written to out_runs.
+    Base::Property<bool> m_produce_runs;
+
+    Types::Blueball::HSVSegmenter m_segmenter;
 };
 
 }//: namespace Blueball
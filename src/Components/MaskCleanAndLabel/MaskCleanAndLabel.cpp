@@ -0,0 +1,127 @@
+/*!
+ * \file MaskCleanAndLabel.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <memory>
+#include <string>
+
+#include "MaskCleanAndLabel.hpp"
+#include "Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+MaskCleanAndLabel::MaskCleanAndLabel(const std::string & name) : Base::Component(name),
+    m_close_iterations("close_iterations", 3, "range"),
+    m_open_iterations("open_iterations", 3, "range"),
+    m_min_size("min_size", 0, "range")
+{
+    m_close_iterations.addConstraint("0");
+    m_close_iterations.addConstraint("20");
+    registerProperty(m_close_iterations);
+
+    m_open_iterations.addConstraint("0");
+    m_open_iterations.addConstraint("20");
+    registerProperty(m_open_iterations);
+
+    m_min_size.addConstraint("0");
+    m_min_size.addConstraint("1000000");
+    registerProperty(m_min_size);
+
+    LOG(LTRACE) << "Hello MaskCleanAndLabel\n";
+}
+
+MaskCleanAndLabel::~MaskCleanAndLabel()
+{
+    LOG(LTRACE) << "Good bye MaskCleanAndLabel\n";
+}
+
+void MaskCleanAndLabel::prepareInterface()
+{
+
+    LOG(LTRACE) << "MaskCleanAndLabel::initialize\n";
+
+    h_onNewImage.setup(this, &MaskCleanAndLabel::onNewImage);
+    registerHandler("onNewImage", &h_onNewImage);
+
+    registerStream("in_img", &in_img);
+    addDependency("onNewImage", &in_img);
+
+    registerStream("out_blobs", &out_blobs);
+
+}
+
+bool MaskCleanAndLabel::onInit()
+{
+    return true;
+}
+
+bool MaskCleanAndLabel::onFinish()
+{
+    LOG(LTRACE) << "MaskCleanAndLabel::finish\n";
+
+    return true;
+}
+
+bool MaskCleanAndLabel::onStep()
+{
+    LOG(LTRACE) << "MaskCleanAndLabel::step\n";
+    return true;
+}
+
+bool MaskCleanAndLabel::onStop()
+{
+    return true;
+}
+
+bool MaskCleanAndLabel::onStart()
+{
+    return true;
+}
+
+void MaskCleanAndLabel::onNewImage()
+{
+    LOG(LTRACE) << "MaskCleanAndLabel::onNewImage\n";
+    try {
+        cv::Mat mask = in_img.read();
+        CV_Assert(mask.type() == CV_8UC1);
+
+        m_morphology.create(mask.size(), m_close_iterations, m_open_iterations);
+        m_labeler.reset();
+
+        for (int y = 0; y < mask.rows; ++y) {
+            m_morphology.push(mask.ptr <uchar> (y));
+
+            // morphology lags a few rows behind the input
+            while (const uchar* row = m_morphology.pop()) {
+                m_runs.clear();
+                Types::Blueball::extractRuns(row, mask.cols, 0, m_runs);
+                if (!m_runs.empty())
+                    m_labeler.addRow(m_morphology.lastRow(), &m_runs[0], m_runs.size());
+            }
+        }
+
+        Types::Blueball::SharedPool<Types::Blueball::RunBlobs>::Pointer blobs = m_blob_pool.get();
+        m_labeler.finish(*blobs, m_min_size);
+
+        out_blobs.write(blobs);
+
+    }
+    catch (Common::DisCODeException& ex) {
+        LOG(LERROR) << ex.what() << "\n";
+        ex.printStackTrace();
+        exit(EXIT_FAILURE);
+    }
+    catch (const char * ex) {
+        LOG(LERROR) << ex;
+    }
+    catch (...) {
+        LOG(LERROR) << "MaskCleanAndLabel::onNewImage failed\n";
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Processors
@@ -0,0 +1,123 @@
+/*!
+ * \file MaskCleanAndLabel.hpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef MASK_CLEAN_AND_LABEL_HPP_
+#define MASK_CLEAN_AND_LABEL_HPP_
+
+#include "Component_Aux.hpp"
+#include "Component.hpp"
+#include "DataStream.hpp"
+
+#include "Property.hpp"
+
+#include <opencv2/opencv.hpp>
+
+#include "Types/Runs.hpp"
+#include "Types/SharedPool.hpp"
+#include "Types/RollingMorphology.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class MaskCleanAndLabel
+ * \brief Closes and opens segmented mask and finds 8-connected blobs in one pass.
+ *
+ * Replaces CvMorphology (MORPH_CLOSE) + CvMorphology (MORPH_OPEN) +
+ * BlobExtractor chain. Morphology is computed in a rolling buffer of a
+ * few rows and each cleaned row goes straight to the run labeler, so
+ * no intermediate image is stored.
+ */
+class MaskCleanAndLabel: public Base::Component
+{
+public:
+    /*!
+     * Constructor.
+     */
+    MaskCleanAndLabel(const std::string & name = "");
+
+    /*!
+     * Destructor
+     */
+    virtual ~MaskCleanAndLabel();
+
+
+    void prepareInterface();
+
+protected:
+
+    /*!
+     * Connects source to given device.
+     */
+    bool onInit();
+
+    /*!
+     * Disconnect source from device, closes streams, etc.
+     */
+    bool onFinish();
+
+    /*!
+     * Retrieves data from device.
+     */
+    bool onStep();
+
+    /*!
+     * Start component
+     */
+    bool onStart();
+
+    /*!
+     * Stop component
+     */
+    bool onStop();
+
+
+    /*!
+     * Event handler function.
+     */
+    void onNewImage();
+
+    /// Event handler.
+    Base::EventHandler <MaskCleanAndLabel> h_onNewImage;
+
+    /// Input mask
+    Base::DataStreamIn <cv::Mat> in_img;
+
+    /// Output data stream - blobs, the largest first
+    Base::DataStreamOut <Types::Blueball::SharedRunBlobs> out_blobs;
+
+private:
+    Types::Blueball::RollingMorphology m_morphology;
+
+    Types::Blueball::RunLabeler m_labeler;
+
+    /// Output blob lists, recycled once readers drop them.
+    Types::Blueball::SharedPool<Types::Blueball::RunBlobs> m_blob_pool;
+
+    /// Runs of the current row.
+    std::vector<Types::Blueball::Run> m_runs;
+
+    /// Number of closing iterations with 3x3 kernel.
+    Base::Property<int> m_close_iterations;
+
+    /// Number of opening iterations with 3x3 kernel.
+    Base::Property<int> m_open_iterations;
+
+    /// Minimal blob area, in pixels.
+    Base::Property<int> m_min_size;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+
+/*
+ * Register processor component.
+ */
+REGISTER_COMPONENT("MaskCleanAndLabel", Processors::Blueball::MaskCleanAndLabel)
+
+#endif /* MASK_CLEAN_AND_LABEL_HPP_ */
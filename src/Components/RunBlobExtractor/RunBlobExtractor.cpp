@@ -0,0 +1,107 @@
+/*!
+ * \file RunBlobExtractor.cpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <memory>
+#include <string>
+
+#include "RunBlobExtractor.hpp"
+#include "Logger.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+RunBlobExtractor::RunBlobExtractor(const std::string & name) : Base::Component(name),
+    m_min_size("min_size", 0, "range")
+{
+    m_min_size.addConstraint("0");
+    m_min_size.addConstraint("1000000");
+    registerProperty(m_min_size);
+
+    LOG(LTRACE) << "Hello RunBlobExtractor\n";
+}
+
+RunBlobExtractor::~RunBlobExtractor()
+{
+    LOG(LTRACE) << "Good bye RunBlobExtractor\n";
+}
+
+void RunBlobExtractor::prepareInterface()
+{
+
+    LOG(LTRACE) << "RunBlobExtractor::initialize\n";
+
+    h_onNewImage.setup(this, &RunBlobExtractor::onNewImage);
+    registerHandler("onNewImage", &h_onNewImage);
+
+    registerStream("in_runs", &in_runs);
+    addDependency("onNewImage", &in_runs);
+
+    registerStream("out_blobs", &out_blobs);
+
+}
+
+bool RunBlobExtractor::onInit()
+{
+    return true;
+}
+
+bool RunBlobExtractor::onFinish()
+{
+    LOG(LTRACE) << "RunBlobExtractor::finish\n";
+
+    return true;
+}
+
+bool RunBlobExtractor::onStep()
+{
+    LOG(LTRACE) << "RunBlobExtractor::step\n";
+    return true;
+}
+
+bool RunBlobExtractor::onStop()
+{
+    return true;
+}
+
+bool RunBlobExtractor::onStart()
+{
+    return true;
+}
+
+void RunBlobExtractor::onNewImage()
+{
+    LOG(LTRACE) << "RunBlobExtractor::onNewImage\n";
+    try {
+        // shared with the producer, nothing is copied
+        Types::Blueball::SharedRunMask runs = in_runs.read();
+        if (!runs)
+            return;
+
+        m_labeler.reset();
+        Types::Blueball::labelRuns(*runs, m_labeler);
+
+        Types::Blueball::SharedPool<Types::Blueball::RunBlobs>::Pointer blobs = m_blob_pool.get();
+        m_labeler.finish(*blobs, m_min_size);
+
+        out_blobs.write(blobs);
+
+    }
+    catch (Common::DisCODeException& ex) {
+        LOG(LERROR) << ex.what() << "\n";
+        ex.printStackTrace();
+        exit(EXIT_FAILURE);
+    }
+    catch (const char * ex) {
+        LOG(LERROR) << ex;
+    }
+    catch (...) {
+        LOG(LERROR) << "RunBlobExtractor::onNewImage failed\n";
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Processors
@@ -0,0 +1,110 @@
+/*!
+ * \file RunBlobExtractor.hpp
+ * \brief
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef RUN_BLOB_EXTRACTOR_HPP_
+#define RUN_BLOB_EXTRACTOR_HPP_
+
+#include "Component_Aux.hpp"
+#include "Component.hpp"
+#include "DataStream.hpp"
+
+#include "Property.hpp"
+
+#include <opencv2/opencv.hpp>
+
+#include "Types/Runs.hpp"
+#include "Types/SharedPool.hpp"
+
+namespace Processors {
+namespace Blueball {
+
+/*!
+ * \class RunBlobExtractor
+ * \brief Finds 8-connected blobs in run-length encoded masks.
+ *
+ * Runs written by LUT are labeled with union-find directly, so the
+ * full resolution mask is never scanned. Blobs are described by
+ * their raw moments and bounding boxes.
+ */
+class RunBlobExtractor: public Base::Component
+{
+public:
+    /*!
+     * Constructor.
+     */
+    RunBlobExtractor(const std::string & name = "");
+
+    /*!
+     * Destructor
+     */
+    virtual ~RunBlobExtractor();
+
+
+    void prepareInterface();
+
+protected:
+
+    /*!
+     * Connects source to given device.
+     */
+    bool onInit();
+
+    /*!
+     * Disconnect source from device, closes streams, etc.
+     */
+    bool onFinish();
+
+    /*!
+     * Retrieves data from device.
+     */
+    bool onStep();
+
+    /*!
+     * Start component
+     */
+    bool onStart();
+
+    /*!
+     * Stop component
+     */
+    bool onStop();
+
+
+    /*!
+     * Event handler function.
+     */
+    void onNewImage();
+
+    /// Event handler.
+    Base::EventHandler <RunBlobExtractor> h_onNewImage;
+
+    /// Input mask - runs of foreground pixels, shared with the producer
+    Base::DataStreamIn <Types::Blueball::SharedRunMask> in_runs;
+
+    /// Output data stream - blobs, the largest first
+    Base::DataStreamOut <Types::Blueball::SharedRunBlobs> out_blobs;
+
+private:
+    Types::Blueball::RunLabeler m_labeler;
+
+    /// Output blob lists, recycled once readers drop them.
+    Types::Blueball::SharedPool<Types::Blueball::RunBlobs> m_blob_pool;
+
+    /// Minimal blob area, in pixels.
+    Base::Property<int> m_min_size;
+};
+
+}//: namespace Blueball
+}//: namespace Processors
+
+
+/*
+ * Register processor component.
+ */
+REGISTER_COMPONENT("RunBlobExtractor", Processors::Blueball::RunBlobExtractor)
+
+#endif /* RUN_BLOB_EXTRACTOR_HPP_ */
@@ -0,0 +1,119 @@
+/*!
+ * \file AllocationTest.cpp
+ * \brief Counts heap allocations of the per-frame blob path.
+ * \author qiubix
+ * \date 2026-10-17
+ *
+ * Runs the steps of tasks/sequence_runs.xml after segmentation - LUT
+ * encoding the mask to runs, RunBlobExtractor and FeatureExtraction
+ * (in_runBlobs path, default properties) - on a synthetic moving ball and
+ * counts calls to operator new once the buffers have warmed up. Any
+ * allocation in the steady state fails the test.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <opencv2/core/core.hpp>
+
+#include "Types/Runs.hpp"
+#include "Types/BallCandidate.hpp"
+#include "Types/SharedPool.hpp"
+
+namespace {
+
+bool counting = false;
+long allocations = 0;
+
+void drawDisk(cv::Mat& mask, int cx, int cy, int r)
+{
+    for (int y = std::max(0, cy - r); y < std::min(mask.rows, cy + r + 1); ++y) {
+        uchar* row = mask.ptr <uchar> (y);
+        for (int x = std::max(0, cx - r); x < std::min(mask.cols, cx + r + 1); ++x)
+            row[x] = ((x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r) ? 255 : 0;
+    }
+}
+
+}//: namespace
+
+void* operator new(std::size_t size) throw (std::bad_alloc)
+{
+    if (counting)
+        ++allocations;
+    void* p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) throw ()
+{
+    std::free(p);
+}
+
+int main(int argc, char** argv)
+{
+    using namespace Types::Blueball;
+
+    const int frames = (argc > 1) ? atoi(argv[1]) : 1000;
+    const int warmup = 10;
+    const int max_balls = 4;
+
+    cv::Mat mask(240, 320, CV_8UC1);
+    cv::Mat hue, hsv;
+
+    SharedPool<RunMask> runs_pool;
+    RunLabeler labeler;
+    SharedPool<RunBlobs> pool;
+    BallCandidates candidates;
+    candidates.reserve(max_balls);
+
+    // last values held by data streams
+    SharedRunMask runs_stream;
+    SharedRunBlobs blobs_stream;
+    BallFeatures features_stream;
+
+    for (int frame = 0; frame < warmup + frames; ++frame) {
+        counting = (frame >= warmup);
+
+        // a ball moving over two still spots
+        std::fill(mask.ptr(0), mask.ptr(0) + mask.rows * mask.cols, 0);
+        drawDisk(mask, 40 + frame % 240, 120 + (frame % 7) - 3, 30);
+        drawDisk(mask, 20, 20, 5);
+        drawDisk(mask, 300, 220, 8);
+
+        // LUT, produce_runs
+        SharedPool<RunMask>::Pointer runs = runs_pool.get();
+        encodeRuns(mask, cv::Rect(0, 0, mask.cols, mask.rows), *runs);
+        runs_stream = runs;
+        runs.reset();
+
+        // RunBlobExtractor
+        SharedRunMask in_runs = runs_stream;
+        labeler.reset();
+        labelRuns(*in_runs, labeler);
+        SharedPool<RunBlobs>::Pointer blobs = pool.get();
+        labeler.finish(*blobs, 20);
+        blobs_stream = blobs;
+        blobs.reset();
+
+        // FeatureExtraction::onRunBlobs
+        SharedRunBlobs run_blobs = blobs_stream;
+        candidates.clear();
+        int count = std::min((int) run_blobs->size(), max_balls);
+        for (int i = 0; i < count; ++i) {
+            BallCandidate ball;
+            describeBlob((*run_blobs)[i].moments, hue, hsv, false, false, ball);
+            ball.features.frame_id = frame;
+            candidates.push_back(ball);
+        }
+        if (!candidates.empty())
+            features_stream = candidates[0].features;
+    }
+    counting = false;
+
+    printf("%ld allocations in %d frames, last ball at (%.1f, %.1f)\n", allocations, frames,
+            features_stream.center.x, features_stream.center.y);
+    return allocations == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
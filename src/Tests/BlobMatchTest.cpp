@@ -0,0 +1,93 @@
+/*!
+ * \file BlobMatchTest.cpp
+ * \brief Checks that FeatureExtraction matches CvBlobs blobs to mask components.
+ * \author qiubix
+ * \date 2026-10-17
+ *
+ * A large rectangle and a smaller L-shaped blob, one pixel apart, with
+ * the rectangle reaching into the bounding box of the L. Components of
+ * the whole mask are matched by bounding box and area (pixel count and
+ * contour-based area, as CvBlobs reports it). The largest component
+ * inside the bounding box of the L is a clipped piece of the rectangle,
+ * so picking it would describe the wrong blob.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <opencv2/core/core.hpp>
+
+#include "Types/Runs.hpp"
+
+namespace {
+
+int failures = 0;
+
+void fill(cv::Mat& mask, const cv::Rect& r)
+{
+    for (int y = r.y; y < r.y + r.height; ++y)
+        for (int x = r.x; x < r.x + r.width; ++x)
+            mask.ptr <uchar> (y)[x] = 255;
+}
+
+void check(bool condition, const char* what)
+{
+    if (!condition) {
+        printf("failed: %s\n", what);
+        ++failures;
+    }
+}
+
+}//: namespace
+
+int main()
+{
+    using namespace Types::Blueball;
+
+    cv::Mat mask(60, 100, CV_8UC1);
+    std::fill(mask.ptr(0), mask.ptr(0) + mask.rows * mask.cols, 0);
+
+    // rectangle, 45 x 36 = 1620 pixels
+    const cv::Rect large(54, 0, 45, 36);
+    fill(mask, large);
+
+    // L, 3 pixels thick, 31 x 31 box = 93 + 84 = 177 pixels, separated
+    // from the rectangle by column 53 and row 36
+    const cv::Rect small(50, 10, 31, 31);
+    fill(mask, cv::Rect(50, 10, 3, 31));
+    fill(mask, cv::Rect(53, 38, 28, 3));
+
+    RunLabeler labeler;
+    RunBlobs blobs;
+    labeler.addMask(mask, cv::Rect(0, 0, mask.cols, mask.rows));
+    labeler.finish(blobs);
+    check(blobs.size() == 2, "two components");
+    if (blobs.size() != 2)
+        return EXIT_FAILURE;
+
+    // what labeling inside the box of the L alone would pick
+    RunBlobs clipped;
+    labeler.addMask(mask, small);
+    labeler.finish(clipped);
+    check(!clipped.empty() && clipped[0].area() != 177, "rectangle dominates the box of the L");
+
+    int match = matchBlob(blobs, small, 177);
+    check(match >= 0 && blobs[match].area() == 177, "L matched by pixel count");
+    check(match >= 0 && blobs[match].bbox == small, "L matched with its own box");
+
+    match = matchBlob(blobs, large, 1620);
+    check(match >= 0 && blobs[match].area() == 1620, "rectangle matched by pixel count");
+
+    // contour-based areas, polygons through border pixel centres
+    match = matchBlob(blobs, small, 30 * 2 + 30 * 2 - 4);
+    check(match >= 0 && blobs[match].area() == 177, "L matched by contour area");
+    match = matchBlob(blobs, large, 44 * 35);
+    check(match >= 0 && blobs[match].area() == 1620, "rectangle matched by contour area");
+
+    // boxes off by more than a pixel, or areas too far apart, don't match
+    check(matchBlob(blobs, cv::Rect(52, 10, 31, 31), 177) < 0, "shifted box");
+    check(matchBlob(blobs, small, 676) < 0, "area of the clipped rectangle");
+
+    printf("%d failures\n", failures);
+    return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,132 @@
+/*!
+ * \file CoarseToFineBench.cpp
+ * \brief Times ColorSegment work per frame, at full resolution and coarse-to-fine.
+ * \author qiubix
+ * \date 2026-10-17
+ *
+ * Runs the steps of ColorSegment (with produce_hue and produce_runs) and
+ * RunBlobExtractor on a synthetic frame with one blue ball, prints mean
+ * time per frame for each coarse_scale and checks that the ball moments
+ * match the full resolution ones.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+#include <opencv2/core/core.hpp>
+
+#include "Types/BgrSegmentation.hpp"
+#include "Types/Runs.hpp"
+
+namespace {
+
+// LUT default thresholds, hue in OpenCV range
+const int hue_1 = 180 / 2, hue_2 = 240 / 2, sat_1 = 100, val_1 = 100;
+
+const int strip_bytes = 32768;
+
+/// Gray noise with a blue ball.
+void makeFrame(cv::Mat& bgr, int cx, int cy, int r)
+{
+    srand(7);
+    for (int y = 0; y < bgr.rows; ++y) {
+        uchar* p = bgr.ptr <uchar> (y);
+        for (int x = 0; x < bgr.cols; ++x, p += 3) {
+            bool ball = (x - cx) * (x - cx) + (y - cy) * (y - cy) <= r * r;
+            int g = 90 + rand() % 60;
+            p[0] = ball ? 200 : g;
+            p[1] = ball ? 60 : g + rand() % 20;
+            p[2] = ball ? 30 : g + rand() % 20;
+        }
+    }
+}
+
+}//: namespace
+
+int main(int argc, char** argv)
+{
+    using namespace Types::Blueball;
+
+    const int frames = (argc > 1) ? atoi(argv[1]) : 5;
+    const int width = (argc > 2) ? atoi(argv[2]) : 3840;
+    const int height = (argc > 3) ? atoi(argv[3]) : 2160;
+
+    cv::Mat bgr(height, width, CV_8UC3);
+    makeFrame(bgr, width * 2 / 3, height / 3, height / 20);
+
+    HSVSegmenter segmenter;
+    segmenter.setKernel("auto");
+    segmenter.setThresholds(makeThresholds(hue_1, hue_2, sat_1, val_1), "");
+
+    cv::Mat segments(height, width, CV_8UC1);
+    cv::Mat hue(height, width, CV_8UC1);
+    cv::Mat hsv_strip;
+    CoarseRegions coarse;
+    std::vector<cv::Rect> regions;
+    RunMask runs;
+    RunLabeler labeler;
+    RunBlobs blobs;
+    RawMoments reference;
+
+    const int scales[] = { 1, 4, 8 };
+    const cv::Rect frame(0, 0, width, height);
+
+    printf("%dx%d, %s kernel, %d frames\n", width, height, segmenter.kernel().c_str(), frames);
+    printf("scale   regions   pixels   segment [ms]   labels [ms]   total [ms]   m00\n");
+    for (size_t s = 0; s < sizeof(scales) / sizeof(scales[0]); ++s) {
+        int scale = scales[s];
+        coarse.configure(scale, 16, 2, 8);
+
+        int64 t_segment = 0, t_label = 0;
+        long pixels = 0;
+        for (int f = 0; f < frames; ++f) {
+            int64 t0 = cv::getTickCount();
+
+            // ColorSegment::onNewImage
+            regions.clear();
+            if (scale > 1) {
+                regions = coarse.find(segmenter, bgr, frame);
+                segments.setTo(0);
+                hue.setTo(0);
+            } else {
+                regions.push_back(frame);
+            }
+            pixels = 0;
+            for (size_t i = 0; i < regions.size(); ++i) {
+                segmentBgr(segmenter, bgr, regions[i], strip_bytes / (3 * regions[i].width), hsv_strip, segments, hue);
+                pixels += regions[i].area();
+            }
+            encodeRuns(segments, regions, runs);
+
+            int64 t1 = cv::getTickCount();
+
+            // RunBlobExtractor::onNewImage
+            labeler.reset();
+            labelRuns(runs, labeler);
+            labeler.finish(blobs, 500);
+
+            int64 t2 = cv::getTickCount();
+            t_segment += t1 - t0;
+            t_label += t2 - t1;
+        }
+
+        if (blobs.empty()) {
+            printf("%5d   ball not found\n", scale);
+            return EXIT_FAILURE;
+        }
+        if (scale == 1)
+            reference = blobs[0].moments;
+        bool same = blobs[0].moments.m00 == reference.m00 && blobs[0].moments.m20 == reference.m20
+                && blobs[0].moments.m11 == reference.m11 && blobs[0].moments.m02 == reference.m02;
+
+        double ms = 1000.0 / cv::getTickFrequency() / frames;
+        printf("%5d %9d %8ld %14.2f %13.2f %12.2f   %.0f%s\n", scale, (int) regions.size(), pixels,
+                t_segment * ms, t_label * ms, (t_segment + t_label) * ms, blobs[0].moments.m00,
+                same ? "" : " (differs)");
+        if (!same)
+            return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+/*!
+ * \file HistogramBench.cpp
+ * \brief Times hue and hue/saturation histograms per blob.
+ * \author qiubix
+ * \date 2026-10-17
+ *
+ * Prints mean time of hueHistogram() and hueSatHistogram() for balls of
+ * a few sizes on a 640x480 image with random pixels.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <opencv2/core/core.hpp>
+
+#include "Types/HueHistogram.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace Types::Blueball;
+
+    const int repeats = (argc > 1) ? atoi(argv[1]) : 2000;
+    const int radii[] = { 10, 30, 60, 120 };
+
+    cv::Mat hsv(480, 640, CV_8UC3);
+    cv::Mat hue(480, 640, CV_8UC1);
+    srand(1);
+    for (int y = 0; y < hsv.rows; ++y) {
+        uchar* p = hsv.ptr <uchar> (y);
+        uchar* h = hue.ptr <uchar> (y);
+        for (int x = 0; x < hsv.cols; ++x) {
+            p[3 * x] = h[x] = rand() % 180;
+            p[3 * x + 1] = rand() % 256;
+            p[3 * x + 2] = rand() % 256;
+        }
+    }
+
+    float hue_hist[8], sat_hist[4];
+    float checksum = 0;
+
+    printf("radius   pixels   hue [ms]   hue+sat [ms]\n");
+    for (size_t i = 0; i < sizeof(radii) / sizeof(radii[0]); ++i) {
+        float r = radii[i];
+        // slightly tilted and flattened, as a ball seen from the side
+        cv::RotatedRect ellipse(cv::Point2f(320.5f, 240.5f), cv::Size2f(2 * r, 1.6f * r), 20);
+
+        int64 t0 = cv::getTickCount();
+        for (int k = 0; k < repeats; ++k) {
+            hueHistogram(hue, ellipse, hue_hist, 8);
+            checksum += hue_hist[k % 8];
+        }
+        int64 t1 = cv::getTickCount();
+        for (int k = 0; k < repeats; ++k) {
+            hueSatHistogram(hsv, ellipse, hue_hist, 8, sat_hist, 4);
+            checksum += sat_hist[k % 4];
+        }
+        int64 t2 = cv::getTickCount();
+
+        double ms = 1000.0 / cv::getTickFrequency() / repeats;
+        printf("%6d %8d %10.4f %14.4f\n", radii[i], (int) (CV_PI * r * 0.8 * r), (t1 - t0) * ms, (t2 - t1) * ms);
+    }
+
+    // keeps the loops from being optimized out
+    return checksum < 0;
+}
@@ -0,0 +1,72 @@
+/*!
+ * \file MailboxTest.cpp
+ * \brief Checks that Mailbox passes the newest value between two threads.
+ * \author qiubix
+ * \date 2026-10-17
+ *
+ * Writer posts increasing sequence numbers with a checksum, reader takes
+ * them as fast as it can. Every taken value must be complete, newer than
+ * the previous one, and the last posted value must always be delivered.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+
+#include <boost/thread/thread.hpp>
+
+#include "Types/Mailbox.hpp"
+
+namespace {
+
+struct Record
+{
+    unsigned long sequence;
+    unsigned long payload[8];
+};
+
+Types::Blueball::Mailbox<Record> mailbox;
+boost::atomic<bool> writing(true);
+unsigned long taken = 0, errors = 0, last = 0;
+
+void readAll()
+{
+    for (;;) {
+        bool done = !writing;
+        while (mailbox.take()) {
+            const Record& r = mailbox.front();
+            for (int i = 0; i < 8; ++i)
+                if (r.payload[i] != r.sequence * (i + 1))
+                    ++errors;
+            if (r.sequence <= last)
+                ++errors;
+            last = r.sequence;
+            ++taken;
+        }
+        if (done)
+            return;
+    }
+}
+
+}//: namespace
+
+int main(int argc, char** argv)
+{
+    const unsigned long count = (argc > 1) ? strtoul(argv[1], NULL, 10) : 1000000;
+
+    boost::thread reader(readAll);
+    for (unsigned long s = 1; s <= count; ++s) {
+        Record& r = mailbox.back();
+        r.sequence = s;
+        for (int i = 0; i < 8; ++i)
+            r.payload[i] = s * (i + 1);
+        mailbox.post();
+        // let the reader in often, also on a single core
+        if (s % 64 == 0)
+            boost::this_thread::yield();
+    }
+    writing = false;
+    reader.join();
+
+    printf("%lu posted, %lu taken, last %lu, %lu errors\n", count, taken, last, errors);
+    return (errors == 0 && last == count) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,99 @@
+/*!
+ * \file NetworkBench.cpp
+ * \brief Times SMILE inference with root definitions and with virtual evidence.
+ * \author qiubix
+ * \date 2026-10-17
+ *
+ * Loads the ball network, binds it as HypothesesEvaluation does and
+ * feeds the same random root probabilities to two evaluators forced to
+ * use SMILE (compiled_max_states = 0): one rewriting root definitions
+ * (virtual_evidence = 0), one passing virtual evidence (virtual_evidence
+ * = 1). Prints mean time per frame of each and the largest difference
+ * of their posteriors.
+ *
+ * Usage: NetworkBench [network file] [frames]
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "NetworkBinding.hpp"
+#include "NetworkEvaluator.hpp"
+#include "NetworkCache.hpp"
+
+using namespace Processors::Blueball;
+
+namespace {
+
+/// Evaluates all frames, returns mean milliseconds per frame and stores flat posteriors.
+double run(DSL_network& net, const NetworkBinding& binding, bool virtual_evidence,
+        const std::vector<double>& probabilities, std::vector<double>& flat)
+{
+    NetworkEvaluator evaluator;
+    if (!evaluator.init(net, binding, 0, virtual_evidence)) {
+        printf("can't copy network\n");
+        exit(EXIT_FAILURE);
+    }
+    if (evaluator.virtualEvidence() != virtual_evidence) {
+        printf("virtual evidence can't be used with this network\n");
+        exit(EXIT_FAILURE);
+    }
+
+    int frames = probabilities.size() / 2;
+    flat.resize(frames);
+
+    int64 start = cv::getTickCount();
+    for (int i = 0; i < frames; ++i) {
+        evaluator.applyEvidence(&probabilities[2 * i]);
+        evaluator.updateBeliefs();
+        flat[i] = evaluator.posterior(binding.flat, binding.flat_yes);
+    }
+    return 1000.0 * (cv::getTickCount() - start) / cv::getTickFrequency() / frames;
+}
+
+}//: namespace
+
+int main(int argc, char** argv)
+{
+    const char* path = (argc > 1) ? argv[1] : "in_blueball_network.xdsl";
+    const int frames = (argc > 2) ? atoi(argv[2]) : 10000;
+
+    DSL_network net;
+    if (NetworkCache::load(path, net) != DSL_OKAY) {
+        printf("can't load %s\n", path);
+        return EXIT_FAILURE;
+    }
+    NetworkBinding binding;
+    if (!binding.bind(net)) {
+        printf("%s does not match the ball network\n", path);
+        return EXIT_FAILURE;
+    }
+
+    // random root probabilities, the same for both modes; zero and one
+    // occur as often as they do for real features
+    std::vector<double> probabilities(2 * frames);
+    srand(1);
+    for (int i = 0; i < 2 * frames; ++i) {
+        double p = (rand() % 1201) / 1000.0 - 0.1;
+        probabilities[i] = std::min(1.0, std::max(0.0, p));
+    }
+
+    std::vector<double> flat_definitions, flat_virtual;
+    double ms_definitions = run(net, binding, false, probabilities, flat_definitions);
+    double ms_virtual = run(net, binding, true, probabilities, flat_virtual);
+
+    double max_difference = 0;
+    for (int i = 0; i < frames; ++i)
+        max_difference = std::max(max_difference, std::fabs(flat_definitions[i] - flat_virtual[i]));
+
+    printf("%s, %d frames, SMILE inference\n", path, frames);
+    printf("virtual_evidence 0: %.4f ms per frame\n", ms_definitions);
+    printf("virtual_evidence 1: %.4f ms per frame\n", ms_virtual);
+    printf("largest difference of flat posterior: %g\n", max_difference);
+    return max_difference < 1e-6 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
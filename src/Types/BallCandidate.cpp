@@ -0,0 +1,48 @@
+/*!
+ * \file BallCandidate.cpp
+ * \brief Features of a blob that may be the ball.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <math.h>
+
+#include "BallCandidate.hpp"
+#include "EllipseFit.hpp"
+#include "HueHistogram.hpp"
+
+namespace Types {
+namespace Blueball {
+
+void describeBlob(const RawMoments& moments, const cv::Mat& hue, const cv::Mat& hsv, bool refine_edges,
+        bool hue_histogram, BallCandidate& candidate)
+{
+    // single ellipse estimate, from moments and optionally moved to hue edges
+    candidate.ellipse = ellipseFromMoments(moments);
+    const cv::RotatedRect& r2 = candidate.ellipse;
+
+    if (refine_edges && !hue.empty())
+        refineEllipse(hue, candidate.ellipse);
+
+    // ratio of the final ellipse, independent of which side is the width
+    float major = std::max(r2.size.width, r2.size.height);
+    float minor = std::min(r2.size.width, r2.size.height);
+    candidate.axis_ratio = (major > 0) ? minor / major : 0;
+
+    BallFeatures& features = candidate.features;
+    features.a = major/2;
+    features.b = minor/2;
+    features.convexity = features.b/features.a;
+    features.area = M_PI*4*features.a*features.b;
+    features.center = candidate.ellipse.center;
+    features.moments = moments;
+    if (hue_histogram && !hsv.empty())
+        hueSatHistogram(hsv, candidate.ellipse, features.hue_hist, BallFeatures::HueBins,
+                features.sat_hist, BallFeatures::SatBins);
+    else if (hue_histogram && !hue.empty())
+        hueHistogram(hue, candidate.ellipse, features.hue_hist, BallFeatures::HueBins);
+}
+
+}//: namespace Blueball
+}//: namespace Types
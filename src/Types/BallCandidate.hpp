@@ -0,0 +1,55 @@
+/*!
+ * \file BallCandidate.hpp
+ * \brief Features of a blob that may be the ball.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BALL_CANDIDATE_HPP_
+#define BALL_CANDIDATE_HPP_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "BallFeatures.hpp"
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \struct BallCandidate
+ * \brief Ellipse fitted to a blob and features derived from it.
+ */
+struct BallCandidate
+{
+    /// Ellipse fitted to the blob, in image coordinates.
+    cv::RotatedRect ellipse;
+
+    /// Features, as written by FeatureExtraction to out_features.
+    BallFeatures features;
+
+    /// Minor to major axis ratio of the ellipse, after refinement, in 0..1.
+    double axis_ratio;
+};
+
+/// Candidates ordered from the largest blob.
+typedef std::vector<BallCandidate> BallCandidates;
+
+/*!
+ * Fits ellipse to the blob with given raw moments and fills geometric
+ * features of \p candidate. With nonempty \p hue the ellipse is moved to
+ * hue edges (if \p refine_edges). If \p hue_histogram is set, hue and
+ * saturation histograms are taken from nonempty \p hsv, otherwise only
+ * hue histogram from \p hue. Timestamp and frame number are left to the
+ * caller.
+ *
+ * Nothing is allocated, unless the ellipse is refined.
+ */
+void describeBlob(const RawMoments& moments, const cv::Mat& hue, const cv::Mat& hsv, bool refine_edges,
+        bool hue_histogram, BallCandidate& candidate);
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* BALL_CANDIDATE_HPP_ */
@@ -0,0 +1,43 @@
+/*!
+ * \file BallEvaluation.hpp
+ * \brief Result of evaluating hypotheses about the ball in one frame.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BALL_EVALUATION_HPP_
+#define BALL_EVALUATION_HPP_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \struct BallEvaluation
+ * \brief Probabilities together with the frame they were computed for.
+ *
+ * Evaluation may lag behind image processing, so consumers use frame_id
+ * and timestamp to match it with other results of the same frame.
+ */
+struct BallEvaluation
+{
+    BallEvaluation() :
+        frame_id(0), timestamp(0)
+    {
+    }
+
+    /// Frame id and timestamp of evaluated features.
+    int frame_id;
+    int64 timestamp;
+
+    /// Flat and nonflat probability, for each evaluated candidate in turn.
+    std::vector<double> probabilities;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* BALL_EVALUATION_HPP_ */
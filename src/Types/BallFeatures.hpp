@@ -0,0 +1,71 @@
+/*!
+ * \file BallFeatures.hpp
+ * \brief Features of the ball found in one frame.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BALL_FEATURES_HPP_
+#define BALL_FEATURES_HPP_
+
+#include <algorithm>
+
+#include <opencv2/core/core.hpp>
+
+#include "Runs.hpp"
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \struct BallFeatures
+ * \brief Fixed-size description of a ball, cheap to pass through data streams.
+ *
+ * Holds no pointers, so writing it to a stream and reading it back
+ * never touches the heap.
+ */
+struct BallFeatures
+{
+    /// Number of bins of hue and saturation histograms.
+    enum { HueBins = 8, SatBins = 4 };
+
+    BallFeatures() :
+        a(0), b(0), convexity(0), area(0), timestamp(0), frame_id(0)
+    {
+        std::fill(hue_hist, hue_hist + HueBins, 0.0f);
+        std::fill(sat_hist, sat_hist + SatBins, 0.0f);
+    }
+
+    /// Semi-axes of the fitted ellipse, a >= b.
+    double a;
+    double b;
+
+    /// Ratio b / a.
+    double convexity;
+
+    /// Ellipse area (4 * pi * a * b).
+    double area;
+
+    /// Ellipse center, in image coordinates.
+    cv::Point2f center;
+
+    /// Raw moments of the blob.
+    RawMoments moments;
+
+    /// Normalized hue histogram inside the ellipse, zeros if it wasn't computed.
+    float hue_hist[HueBins];
+
+    /// Normalized saturation histogram inside the ellipse, zeros if there was no HSV image.
+    float sat_hist[SatBins];
+
+    /// cv::getTickCount() when the features were computed.
+    int64 timestamp;
+
+    /// Number of the frame, counted by the producer.
+    int frame_id;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* BALL_FEATURES_HPP_ */
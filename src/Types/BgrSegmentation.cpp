@@ -0,0 +1,141 @@
+/*!
+ * \file BgrSegmentation.cpp
+ * \brief Segmentation of BGR images without storing HSV frame, optionally coarse-to-fine.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "BgrSegmentation.hpp"
+
+namespace Types {
+namespace Blueball {
+
+namespace {
+
+bool leftOf(const cv::Rect& a, const cv::Rect& b)
+{
+    return a.x < b.x;
+}
+
+/// Checks if regions overlap or touch, also diagonally.
+bool adjacent(const cv::Rect& a, const cv::Rect& b)
+{
+    return a.x <= b.x + b.width && b.x <= a.x + a.width
+            && a.y <= b.y + b.height && b.y <= a.y + a.height;
+}
+
+}//: namespace
+
+void segmentBgr(const HSVSegmenter& segmenter, const cv::Mat& bgr, const cv::Rect& region, int strip_rows,
+        cv::Mat& hsv_strip, cv::Mat& segments, cv::Mat& hue)
+{
+    cv::Mat bgr_roi = bgr(region);
+    cv::Mat seg_roi = segments(region);
+    cv::Mat hue_roi;
+    if (!hue.empty())
+        hue_roi = hue(region);
+
+    strip_rows = std::max(1, strip_rows);
+
+    int from_to[] = { 0, 0 };
+    for (int r0 = 0; r0 < region.height; r0 += strip_rows) {
+        int r1 = std::min(region.height, r0 + strip_rows);
+
+        cv::cvtColor(bgr_roi.rowRange(r0, r1), hsv_strip, CV_BGR2HSV);
+
+        for (int i = r0; i < r1; i++) {
+            segmenter.segmentRow(hsv_strip.ptr <uchar> (i - r0), seg_roi.ptr <uchar> (i), region.width);
+        }
+
+        if (!hue_roi.empty()) {
+            cv::Mat hue_rows = hue_roi.rowRange(r0, r1);
+            cv::mixChannels(&hsv_strip, 1, &hue_rows, 1, from_to, 1);
+        }
+    }
+}
+
+CoarseRegions::CoarseRegions() :
+    m_scale(4), m_margin(16), m_min_area(2), m_max_regions(8)
+{
+}
+
+void CoarseRegions::configure(int scale, int margin, int min_area, int max_regions)
+{
+    m_scale = std::max(1, scale);
+    m_margin = std::max(0, margin);
+    m_min_area = std::max(1, min_area);
+    m_max_regions = std::max(1, max_regions);
+}
+
+const std::vector<cv::Rect>& CoarseRegions::find(const HSVSegmenter& segmenter, const cv::Mat& bgr, const cv::Rect& roi)
+{
+    CV_Assert(bgr.type() == CV_8UC3);
+
+    m_regions.clear();
+
+    int scale = m_scale;
+    cv::Size size(roi.width / scale, roi.height / scale);
+    if (size.width <= 0 || size.height <= 0)
+        return m_regions;
+
+    // only centers of the cells are read, the rest of the frame is never touched
+    m_bgr.create(size, CV_8UC3);
+    for (int y = 0; y < size.height; ++y) {
+        const uchar* src = bgr.ptr <uchar> (roi.y + y * scale + scale / 2) + 3 * (roi.x + scale / 2);
+        uchar* dst = m_bgr.ptr <uchar> (y);
+        for (int x = 0; x < size.width; ++x, src += 3 * scale, dst += 3) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+        }
+    }
+
+    cv::cvtColor(m_bgr, m_hsv, CV_BGR2HSV);
+    m_segments.create(size, CV_8UC1);
+    for (int y = 0; y < size.height; ++y)
+        segmenter.segmentRow(m_hsv.ptr <uchar> (y), m_segments.ptr <uchar> (y), size.width);
+
+    m_labeler.reset();
+    m_labeler.addMask(m_segments, cv::Rect(0, 0, size.width, size.height));
+    m_labeler.finish(m_blobs, m_min_area);
+
+    // cell x covers pixels [roi.x + x * scale, roi.x + (x + 1) * scale)
+    int count = std::min((int) m_blobs.size(), m_max_regions);
+    for (int i = 0; i < count; ++i) {
+        const cv::Rect& box = m_blobs[i].bbox;
+        int x0 = roi.x + box.x * scale - m_margin;
+        int y0 = roi.y + box.y * scale - m_margin;
+        int x1 = roi.x + (box.x + box.width) * scale + m_margin;
+        int y1 = roi.y + (box.y + box.height) * scale + m_margin;
+        cv::Rect region = cv::Rect(x0, y0, x1 - x0, y1 - y0) & roi;
+        if (region.width > 0 && region.height > 0)
+            m_regions.push_back(region);
+    }
+
+    // merge until no two regions overlap or touch, there are only a few of them
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < m_regions.size(); ++i) {
+            for (size_t j = i + 1; j < m_regions.size(); ++j) {
+                if (adjacent(m_regions[i], m_regions[j])) {
+                    m_regions[i] |= m_regions[j];
+                    m_regions.erase(m_regions.begin() + j);
+                    merged = true;
+                    --j;
+                }
+            }
+        }
+    }
+
+    std::sort(m_regions.begin(), m_regions.end(), leftOf);
+    return m_regions;
+}
+
+}//: namespace Blueball
+}//: namespace Types
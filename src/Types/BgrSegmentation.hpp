@@ -0,0 +1,82 @@
+/*!
+ * \file BgrSegmentation.hpp
+ * \brief Segmentation of BGR images without storing HSV frame, optionally coarse-to-fine.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BGR_SEGMENTATION_HPP_
+#define BGR_SEGMENTATION_HPP_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "HSVSegmenter.hpp"
+#include "Runs.hpp"
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * Converts \p region of BGR image to HSV in strips of \p strip_rows rows
+ * and labels each strip while it is still in cache. Labels go to the
+ * same region of \p segments, hue to the same region of \p hue, unless
+ * \p hue is empty. Pixels outside the region are not touched.
+ *
+ * \param hsv_strip strip buffer, reused between calls
+ */
+void segmentBgr(const HSVSegmenter& segmenter, const cv::Mat& bgr, const cv::Rect& region, int strip_rows,
+        cv::Mat& hsv_strip, cv::Mat& segments, cv::Mat& hue);
+
+/*!
+ * \class CoarseRegions
+ * \brief Finds regions worth segmenting at full resolution from a sparse sample of BGR image.
+ *
+ * Only the center pixel of every scale x scale cell is converted to HSV
+ * and segmented. Bounding boxes of the largest blobs of that coarse mask
+ * are mapped back to the image and grown by a margin. Overlapping or
+ * touching regions are merged, so regions never share a pixel (nor a run
+ * of segmented pixels). Blobs smaller than a cell may be missed.
+ */
+class CoarseRegions
+{
+public:
+    CoarseRegions();
+
+    /*!
+     * \param scale size of a cell, in pixels
+     * \param margin pixels added around each blob
+     * \param min_area minimal area of a coarse blob, in cells
+     * \param max_regions number of the largest blobs turned into regions
+     */
+    void configure(int scale, int margin, int min_area, int max_regions);
+
+    /// Returns regions inside \p roi of \p bgr, sorted by x.
+    const std::vector<cv::Rect>& find(const HSVSegmenter& segmenter, const cv::Mat& bgr, const cv::Rect& roi);
+
+    int scale() const
+    {
+        return m_scale;
+    }
+
+private:
+    int m_scale;
+    int m_margin;
+    int m_min_area;
+    int m_max_regions;
+
+    /// Buffers of the coarse pass, reused between frames.
+    cv::Mat m_bgr;
+    cv::Mat m_hsv;
+    cv::Mat m_segments;
+    Types::Blueball::RunLabeler m_labeler;
+    Types::Blueball::RunBlobs m_blobs;
+
+    std::vector<cv::Rect> m_regions;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* BGR_SEGMENTATION_HPP_ */
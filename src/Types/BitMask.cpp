@@ -0,0 +1,163 @@
+/*!
+ * \file BitMask.cpp
+ * \brief Binary image with one bit per pixel.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "BitMask.hpp"
+
+namespace Types {
+namespace Blueball {
+
+void packRow(const uchar* src, uint64_t* dst, int width)
+{
+    int words = BitMask::wordsPerRow(width);
+    int x = 0;
+    for (int k = 0; k < words; ++k) {
+        uint64_t word = 0;
+#ifdef __SSE2__
+        if (x + 64 <= width) {
+            const __m128i zero = _mm_setzero_si128();
+            for (int i = 0; i < 4; ++i) {
+                __m128i v = _mm_loadu_si128((const __m128i*) (src + x + 16 * i));
+                // movemask takes the top bit, so compare with zero first
+                uint64_t bits = (uint64_t) (~_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero)) & 0xFFFF);
+                word |= bits << (16 * i);
+            }
+            dst[k] = word;
+            x += 64;
+            continue;
+        }
+#endif
+        int end = std::min(width, x + 64);
+        for (int i = 0; x < end; ++x, ++i) {
+            if (src[x])
+                word |= uint64_t(1) << i;
+        }
+        dst[k] = word;
+    }
+}
+
+void pack(const cv::Mat& src, BitMask& dst)
+{
+    CV_Assert(src.type() == CV_8UC1 && src.size() == dst.size());
+    for (int y = 0; y < src.rows; ++y) {
+        packRow(src.ptr <uchar> (y), dst.row(y), src.cols);
+    }
+}
+
+void unpack(const BitMask& src, cv::Mat& dst)
+{
+    dst.create(src.size(), CV_8UC1);
+    for (int y = 0; y < src.height(); ++y) {
+        const uint64_t* words = src.row(y);
+        uchar* out = dst.ptr <uchar> (y);
+        for (int x = 0; x < src.width(); ++x) {
+            out[x] = (uchar) -(int) ((words[x >> 6] >> (x & 63)) & 1);
+        }
+    }
+}
+
+namespace {
+
+/*!
+ * Word k of a row shifted by d pixels, i.e. bit i of the result is pixel
+ * 64 * k + i + d of the row. Pixels outside the row are given by \p border.
+ */
+inline uint64_t shiftedWord(const uint64_t* row, int stride, int k, int d, uint64_t border)
+{
+    int q = k + (d >> 6);
+    int r = d & 63;
+    uint64_t lo = (q >= 0 && q < stride) ? row[q] : border;
+    if (r == 0)
+        return lo;
+    uint64_t hi = (q + 1 >= 0 && q + 1 < stride) ? row[q + 1] : border;
+    return (lo >> r) | (hi << (64 - r));
+}
+
+/*!
+ * Separable square filter of radius r. Rows outside the image are
+ * skipped and pixels outside of the row equal \p border, so that they
+ * don't affect the result (0 for dilation, ones for erosion).
+ */
+template <bool Dilate>
+void morph(const BitMask& src, BitMask& dst, int r)
+{
+    CV_Assert(&src != &dst);
+
+    const uint64_t border = Dilate ? 0 : ~uint64_t(0);
+    const int height = src.height();
+    const int stride = src.stride();
+    const uint64_t last = src.lastWordMask();
+
+    if (dst.size() != src.size())
+        dst.create(src.size());
+    if (height == 0 || stride == 0)
+        return;
+
+    std::vector<uint64_t> buf(stride);
+
+    for (int y = 0; y < height; ++y) {
+        // vertical pass
+        int y0 = std::max(0, y - r);
+        int y1 = std::min(height - 1, y + r);
+        std::copy(src.row(y0), src.row(y0) + stride, buf.begin());
+        for (int yy = y0 + 1; yy <= y1; ++yy) {
+            const uint64_t* s = src.row(yy);
+            for (int k = 0; k < stride; ++k)
+                buf[k] = Dilate ? (buf[k] | s[k]) : (buf[k] & s[k]);
+        }
+        // bits past the width are outside of the image
+        buf[stride - 1] = Dilate ? (buf[stride - 1] & last) : (buf[stride - 1] | ~last);
+
+        // horizontal pass
+        uint64_t* out = dst.row(y);
+        for (int k = 0; k < stride; ++k) {
+            uint64_t acc = buf[k];
+            for (int d = 1; d <= r; ++d) {
+                uint64_t left = shiftedWord(&buf[0], stride, k, -d, border);
+                uint64_t right = shiftedWord(&buf[0], stride, k, d, border);
+                acc = Dilate ? (acc | left | right) : (acc & left & right);
+            }
+            out[k] = acc;
+        }
+        out[stride - 1] &= last;
+    }
+}
+
+}
+
+void dilate(const BitMask& src, BitMask& dst, int iterations)
+{
+    // n iterations of 3x3 square equal one pass of (2n+1)x(2n+1) square
+    morph <true> (src, dst, std::max(0, iterations));
+}
+
+void erode(const BitMask& src, BitMask& dst, int iterations)
+{
+    morph <false> (src, dst, std::max(0, iterations));
+}
+
+void close(const BitMask& src, BitMask& dst, BitMask& tmp, int iterations)
+{
+    dilate(src, tmp, iterations);
+    erode(tmp, dst, iterations);
+}
+
+void open(const BitMask& src, BitMask& dst, BitMask& tmp, int iterations)
+{
+    erode(src, tmp, iterations);
+    dilate(tmp, dst, iterations);
+}
+
+}//: namespace Blueball
+}//: namespace Types
@@ -0,0 +1,142 @@
+/*!
+ * \file BitMask.hpp
+ * \brief Binary image with one bit per pixel.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef BIT_MASK_HPP_
+#define BIT_MASK_HPP_
+
+#include <stdint.h>
+
+#include <opencv2/core/core.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class BitMask
+ * \brief Binary mask packed into 64-bit words.
+ *
+ * Bit i of word k in a row holds pixel 64 * k + i. Bits past the image
+ * width are always zero. Words are kept in a cv::Mat, so copies passed
+ * through data streams share the data like images do.
+ */
+class BitMask
+{
+public:
+    BitMask() :
+        m_width(0)
+    {
+    }
+
+    /// Allocates mask of given size, contents are undefined.
+    void create(cv::Size size)
+    {
+        m_width = size.width;
+        m_words.create(bufferSize(size), CV_8UC1);
+    }
+
+    /// Wraps already allocated buffer (e.g. taken from a MatPool).
+    void assign(const cv::Mat& words, int width)
+    {
+        m_width = width;
+        m_words = words;
+    }
+
+    int width() const
+    {
+        return m_width;
+    }
+
+    int height() const
+    {
+        return m_words.rows;
+    }
+
+    cv::Size size() const
+    {
+        return cv::Size(m_width, m_words.rows);
+    }
+
+    /// Number of words in a row.
+    int stride() const
+    {
+        return m_words.cols / sizeof(uint64_t);
+    }
+
+    bool empty() const
+    {
+        return m_words.empty();
+    }
+
+    uint64_t* row(int y)
+    {
+        return m_words.ptr <uint64_t> (y);
+    }
+
+    const uint64_t* row(int y) const
+    {
+        return m_words.ptr <uint64_t> (y);
+    }
+
+    /// Underlying buffer.
+    const cv::Mat& data() const
+    {
+        return m_words;
+    }
+
+    static int wordsPerRow(int width)
+    {
+        return (width + 63) / 64;
+    }
+
+    /// Size of CV_8UC1 buffer holding mask of given size.
+    static cv::Size bufferSize(cv::Size size)
+    {
+        return cv::Size(wordsPerRow(size.width) * sizeof(uint64_t), size.height);
+    }
+
+    /// Mask of valid bits in the last word of a row.
+    uint64_t lastWordMask() const
+    {
+        int tail = m_width & 63;
+        return tail ? ((uint64_t(1) << tail) - 1) : ~uint64_t(0);
+    }
+
+private:
+    int m_width;
+    cv::Mat m_words;
+};
+
+/// Packs 0/255 mask row of \p width pixels into words, nonzero bytes become ones.
+void packRow(const uchar* src, uint64_t* dst, int width);
+
+/// Packs 8-bit mask into \p dst, which must already have the same size.
+void pack(const cv::Mat& src, BitMask& dst);
+
+/// Unpacks mask into 0/255 image, \p dst is (re)allocated if needed.
+void unpack(const BitMask& src, cv::Mat& dst);
+
+/*!
+ * Dilation/erosion with 3x3 square, repeated \p iterations times. Pixels
+ * outside the image don't change the result, as in cv::dilate/cv::erode
+ * with default border. \p dst must be a different mask than \p src,
+ * it is (re)allocated if needed.
+ */
+void dilate(const BitMask& src, BitMask& dst, int iterations = 1);
+void erode(const BitMask& src, BitMask& dst, int iterations = 1);
+
+/*!
+ * Morphological closing (dilation then erosion) and opening (erosion then
+ * dilation), as cv::morphologyEx with MORPH_CLOSE/MORPH_OPEN and default
+ * kernel. \p tmp holds the intermediate result.
+ */
+void close(const BitMask& src, BitMask& dst, BitMask& tmp, int iterations = 1);
+void open(const BitMask& src, BitMask& dst, BitMask& tmp, int iterations = 1);
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* BIT_MASK_HPP_ */
@@ -0,0 +1,76 @@
+/*!
+ * \file ColorTable.cpp
+ * \brief Separable HSV lookup table labeling pixels by three byte probes.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+#include "ColorTable.hpp"
+
+namespace Types {
+namespace Blueball {
+
+const int ColorTable::MaxBoxes;
+
+ColorTable::ColorTable()
+{
+    clear();
+}
+
+void ColorTable::clear()
+{
+    memset(m_hue, 0, sizeof(m_hue));
+    memset(m_sat, 0, sizeof(m_sat));
+    memset(m_val, 0, sizeof(m_val));
+    m_boxes = 0;
+}
+
+bool ColorTable::addBox(const HSVThresholds& box)
+{
+    if (m_boxes >= MaxBoxes)
+        return false;
+
+    uchar bit = (uchar) (1 << m_boxes);
+    for (int i = box.hue_lo; i < box.hue_hi; ++i)
+        m_hue[i] |= bit;
+    for (int i = box.sat_lo; i < 256; ++i)
+        m_sat[i] |= bit;
+    for (int i = box.val_lo; i < 256; ++i)
+        m_val[i] |= bit;
+
+    ++m_boxes;
+    return true;
+}
+
+int ColorTable::addBoxes(const std::string& description)
+{
+    int failed = 0;
+    std::istringstream entries(description);
+    std::string entry;
+    while (std::getline(entries, entry, ';')) {
+        if (entry.find_first_not_of(" \t") == std::string::npos)
+            continue;
+
+        int hue_1, hue_2, sat, val;
+        // OpenCV writes hue in range 0..180 instead of 0..360
+        if (sscanf(entry.c_str(), " %d : %d : %d : %d", &hue_1, &hue_2, &sat, &val) != 4
+                || !addBox(makeThresholds(hue_1 >> 1, hue_2 >> 1, sat, val)))
+            ++failed;
+    }
+    return failed;
+}
+
+void ColorTable::segmentRow(const uchar* hsv, uchar* seg, int width) const
+{
+    for (int j = 0; j < width; ++j, hsv += 3) {
+        uchar bits = m_hue[hsv[0]] & m_sat[hsv[1]] & m_val[hsv[2]];
+        seg[j] = (uchar) -(bits != 0);
+    }
+}
+
+}//: namespace Blueball
+}//: namespace Types
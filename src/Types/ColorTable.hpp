@@ -0,0 +1,70 @@
+/*!
+ * \file ColorTable.hpp
+ * \brief Separable HSV lookup table labeling pixels by three byte probes.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef COLOR_TABLE_HPP_
+#define COLOR_TABLE_HPP_
+
+#include <string>
+
+#include "SegmentationKernels.hpp"
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class ColorTable
+ * \brief Union of up to eight HSV boxes encoded as per-channel bitmasks.
+ *
+ * Every box owns one bit. Entry v of a channel table has the bit of each
+ * box whose range on that channel contains v, so pixel (h, s, v) belongs
+ * to the region iff hue[h] & sat[s] & val[v] is nonzero. Classification
+ * costs the same for any number of boxes, e.g. several hue bands.
+ */
+class ColorTable
+{
+public:
+    /// Maximal number of boxes held by the table.
+    static const int MaxBoxes = 8;
+
+    ColorTable();
+
+    /// Removes all boxes, no pixel is labeled afterwards.
+    void clear();
+
+    /*!
+     * Adds box hue_lo <= h < hue_hi, sat >= sat_lo, val >= val_lo.
+     * Returns false when table is already full.
+     */
+    bool addBox(const HSVThresholds& box);
+
+    /*!
+     * Adds boxes described as "hue_1:hue_2:sat:val" entries separated
+     * by ';', using the same units as LUT properties (hue in degrees).
+     * Returns number of boxes that couldn't be parsed or didn't fit.
+     */
+    int addBoxes(const std::string& description);
+
+    int boxes() const
+    {
+        return m_boxes;
+    }
+
+    /// Labels \p width interleaved HSV pixels with 0/255.
+    void segmentRow(const uchar* hsv, uchar* seg, int width) const;
+
+private:
+    uchar m_hue[256];
+    uchar m_sat[256];
+    uchar m_val[256];
+
+    int m_boxes;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* COLOR_TABLE_HPP_ */
@@ -0,0 +1,144 @@
+/*!
+ * \file EllipseFit.cpp
+ * \brief Ellipse estimated from blob moments, with optional edge refinement.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "EllipseFit.hpp"
+
+namespace Types {
+namespace Blueball {
+
+namespace {
+
+/// Value at (x, y), pixels (x + 1, y + 1) must lie inside the image.
+inline float sampleBilinear(const cv::Mat& img, float x, float y)
+{
+    int x0 = cvFloor(x), y0 = cvFloor(y);
+    float fx = x - x0, fy = y - y0;
+    const uchar* r0 = img.ptr <uchar> (y0);
+    const uchar* r1 = img.ptr <uchar> (y0 + 1);
+    return (1 - fy) * ((1 - fx) * r0[x0] + fx * r0[x0 + 1]) + fy * ((1 - fx) * r1[x0] + fx * r1[x0 + 1]);
+}
+
+}
+
+cv::RotatedRect ellipseFromMoments(const RawMoments& m)
+{
+    if (m.m00 <= 0)
+        return cv::RotatedRect();
+
+    double cx = m.m10 / m.m00;
+    double cy = m.m01 / m.m00;
+
+    // normalized central moments - covariance of pixel coordinates
+    double mu20 = m.m20 / m.m00 - cx * cx;
+    double mu02 = m.m02 / m.m00 - cy * cy;
+    double mu11 = m.m11 / m.m00 - cx * cy;
+
+    double common = std::sqrt((mu20 - mu02) * (mu20 - mu02) + 4 * mu11 * mu11);
+    double l1 = 0.5 * (mu20 + mu02 + common);
+    double l2 = std::max(0.0, 0.5 * (mu20 + mu02 - common));
+
+    // variance along the axis of a filled ellipse is (semi-axis)^2 / 4
+    double angle = 0.5 * std::atan2(2 * mu11, mu20 - mu02) * 180.0 / CV_PI;
+    return cv::RotatedRect(cv::Point2f(cx, cy), cv::Size2f(4 * std::sqrt(l1), 4 * std::sqrt(l2)), angle);
+}
+
+bool refineEllipse(const cv::Mat& img, cv::RotatedRect& ellipse, int rays, float ring, float min_contrast)
+{
+    CV_Assert(img.type() == CV_8UC1);
+
+    float ax = ellipse.size.width / 2;
+    float ay = ellipse.size.height / 2;
+    if (ax <= 0 || ay <= 0 || rays < 5)
+        return false;
+
+    double t = ellipse.angle * CV_PI / 180;
+    float cs = std::cos(t), sn = std::sin(t);
+    const cv::Point2f c = ellipse.center;
+
+    // profiles are sampled every half pixel
+    const float step = 0.5f;
+
+    std::vector<cv::Point2f> edges;
+    edges.reserve(rays);
+    std::vector<float> profile;
+
+    for (int i = 0; i < rays; ++i) {
+        double phi = 2 * CV_PI * i / rays;
+
+        // direction to the point of the ellipse with parameter phi
+        float ex = ax * std::cos(phi), ey = ay * std::sin(phi);
+        float dx = ex * cs - ey * sn, dy = ex * sn + ey * cs;
+        float radius = std::sqrt(dx * dx + dy * dy);
+        float ux = dx / radius, uy = dy / radius;
+
+        float r0 = radius * (1 - ring), r1 = radius * (1 + ring);
+        int n = std::max(5, cvCeil((r1 - r0) / step) + 1);
+        float dr = (r1 - r0) / (n - 1);
+
+        float xa = c.x + ux * r0, ya = c.y + uy * r0;
+        float xb = c.x + ux * r1, yb = c.y + uy * r1;
+        if (std::min(xa, xb) < 0 || std::min(ya, yb) < 0
+                || std::max(xa, xb) >= img.cols - 1 || std::max(ya, yb) >= img.rows - 1)
+            continue;
+
+        profile.resize(n);
+        for (int k = 0; k < n; ++k)
+            profile[k] = sampleBilinear(img, c.x + ux * (r0 + k * dr), c.y + uy * (r0 + k * dr));
+
+        // strongest central difference
+        int best = -1;
+        float best_g = min_contrast * 2 * dr;
+        for (int k = 1; k < n - 1; ++k) {
+            float g = std::fabs(profile[k + 1] - profile[k - 1]);
+            if (g > best_g) {
+                best_g = g;
+                best = k;
+            }
+        }
+        if (best < 0)
+            continue;
+
+        // vertex of parabola through the peak and its neighbours
+        float offset = 0;
+        if (best > 1 && best < n - 2) {
+            float gm = std::fabs(profile[best] - profile[best - 2]);
+            float gp = std::fabs(profile[best + 2] - profile[best]);
+            float den = gm - 2 * best_g + gp;
+            if (den < 0)
+                offset = 0.5f * (gm - gp) / den;
+        }
+
+        float r = r0 + (best + offset) * dr;
+        edges.push_back(cv::Point2f(c.x + ux * r, c.y + uy * r));
+    }
+
+    if ((int) edges.size() < std::max(5, rays / 2))
+        return false;
+
+    cv::RotatedRect fitted = cv::fitEllipse(edges);
+
+    // edges of another object or noise - keep the moment estimate
+    float minor = std::min(ellipse.size.width, ellipse.size.height);
+    float shift_x = fitted.center.x - c.x, shift_y = fitted.center.y - c.y;
+    if (shift_x * shift_x + shift_y * shift_y > 0.25f * std::max(1.0f, minor * minor))
+        return false;
+    float area_ratio = (fitted.size.width * fitted.size.height) / (ellipse.size.width * ellipse.size.height);
+    if (!(area_ratio > 0.5f && area_ratio < 2.0f))
+        return false;
+
+    ellipse = fitted;
+    return true;
+}
+
+}//: namespace Blueball
+}//: namespace Types
@@ -0,0 +1,44 @@
+/*!
+ * \file EllipseFit.hpp
+ * \brief Ellipse estimated from blob moments, with optional edge refinement.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef ELLIPSE_FIT_HPP_
+#define ELLIPSE_FIT_HPP_
+
+#include <opencv2/core/core.hpp>
+
+#include "Runs.hpp"
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * Ellipse with the same area and second order central moments as the
+ * blob. Box size holds full axes (width along the major axis), angle is
+ * in degrees.
+ */
+cv::RotatedRect ellipseFromMoments(const RawMoments& m);
+
+/*!
+ * Moves \p ellipse to sub-pixel edges of the object in \p img.
+ *
+ * Edges are searched along \p rays rays from the center, only within
+ * the ring between (1 - \p ring) and (1 + \p ring) of the ellipse
+ * radius. On each ray the strongest gradient of the bilinearly sampled
+ * profile is located with parabolic interpolation, ellipse is then
+ * fitted to the edge points. Image values are compared as plain
+ * numbers, so for hue the object must lie away from the 0/180 wrap.
+ *
+ * \param min_contrast minimal gradient (in image units per pixel) of an edge
+ * \returns false, leaving \p ellipse unchanged, if too few edges were found
+ * or the fitted ellipse differs too much from the initial one
+ */
+bool refineEllipse(const cv::Mat& img, cv::RotatedRect& ellipse, int rays = 32, float ring = 0.3f, float min_contrast = 4.0f);
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* ELLIPSE_FIT_HPP_ */
@@ -0,0 +1,60 @@
+/*!
+ * \file HSVSegmenter.cpp
+ * \brief Segmentation state shared by components labeling HSV pixels.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <cstring>
+
+#include "HSVSegmenter.hpp"
+
+namespace Types {
+namespace Blueball {
+
+HSVSegmenter::HSVSegmenter() :
+    m_segment_row(segmentRowScalar),
+    m_selected("scalar"),
+    m_use_table(false)
+{
+    m_thr = makeThresholds(0, 0, 0, 0);
+    m_table_thr = m_thr;
+}
+
+bool HSVSegmenter::setKernel(const std::string& name)
+{
+    if (!m_requested.empty() && name == m_requested)
+        return false;
+
+    m_segment_row = selectSegmentKernel(name, m_selected);
+    m_requested = name;
+    m_use_table = (name == "table");
+    if (m_use_table) {
+        m_selected = "table";
+        // force rebuild with current thresholds
+        m_table.clear();
+    }
+    return true;
+}
+
+int HSVSegmenter::setThresholds(const HSVThresholds& thr, const std::string& regions)
+{
+    m_thr = thr;
+    if (!m_use_table)
+        return 0;
+
+    if (m_table.boxes() > 0 && regions == m_table_regions
+            && memcmp(&m_thr, &m_table_thr, sizeof(m_thr)) == 0)
+        return 0;
+
+    m_table.clear();
+    m_table.addBox(m_thr);
+    int failed = m_table.addBoxes(regions);
+
+    m_table_thr = m_thr;
+    m_table_regions = regions;
+    return failed;
+}
+
+}//: namespace Blueball
+}//: namespace Types
@@ -0,0 +1,81 @@
+/*!
+ * \file HSVSegmenter.hpp
+ * \brief Segmentation state shared by components labeling HSV pixels.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef HSV_SEGMENTER_HPP_
+#define HSV_SEGMENTER_HPP_
+
+#include <string>
+
+#include "SegmentationKernels.hpp"
+#include "ColorTable.hpp"
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class HSVSegmenter
+ * \brief Holds selected row kernel, thresholds and lookup table.
+ *
+ * Kernel and table are rebuilt only when the requested kernel,
+ * thresholds or extra regions change, so components can pass their
+ * property values every frame.
+ */
+class HSVSegmenter
+{
+public:
+    HSVSegmenter();
+
+    /*!
+     * Selects kernel by name - one of "auto", "scalar", "sse4", "avx2"
+     * or "table". Returns true if selection changed.
+     */
+    bool setKernel(const std::string& name);
+
+    /// Name of the kernel that is actually used.
+    const std::string& kernel() const
+    {
+        return m_selected;
+    }
+
+    /*!
+     * Sets thresholds and additional table regions (see ColorTable::addBoxes).
+     * Returns number of regions ignored when table had to be rebuilt.
+     */
+    int setThresholds(const HSVThresholds& thr, const std::string& regions);
+
+    const HSVThresholds& thresholds() const
+    {
+        return m_thr;
+    }
+
+    /// Labels \p width interleaved HSV pixels with 0/255.
+    void segmentRow(const uchar* hsv, uchar* seg, int width) const
+    {
+        if (m_use_table)
+            m_table.segmentRow(hsv, seg, width);
+        else
+            m_segment_row(hsv, seg, width, m_thr);
+    }
+
+private:
+    SegmentRowFn m_segment_row;
+    std::string m_requested;
+    std::string m_selected;
+    bool m_use_table;
+
+    HSVThresholds m_thr;
+
+    /// Lookup table and parameters it was built from.
+    ColorTable m_table;
+    HSVThresholds m_table_thr;
+    std::string m_table_regions;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* HSV_SEGMENTER_HPP_ */
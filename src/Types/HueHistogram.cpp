@@ -0,0 +1,167 @@
+/*!
+ * \file HueHistogram.cpp
+ * \brief Hue and saturation histograms of pixels inside an ellipse.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "HueHistogram.hpp"
+
+namespace Types {
+namespace Blueball {
+
+namespace {
+
+/*!
+ * \class EllipseSpans
+ * \brief Horizontal spans of image rows lying inside an ellipse.
+ */
+class EllipseSpans
+{
+public:
+    EllipseSpans(const cv::RotatedRect& ellipse, cv::Size size) :
+        m_center(ellipse.center), m_size(size), y0(0), y1(-1)
+    {
+        double ax = ellipse.size.width / 2;
+        double ay = ellipse.size.height / 2;
+        if (ax <= 0 || ay <= 0)
+            return;
+
+        // (x, y) is inside if a * dx^2 + b * dx + c(dy) <= 0
+        double t = ellipse.angle * CV_PI / 180;
+        double cs = std::cos(t), sn = std::sin(t);
+        double ia = 1 / (ax * ax), ib = 1 / (ay * ay);
+        m_a = cs * cs * ia + sn * sn * ib;
+        m_b_dy = 2 * sn * cs * (ia - ib);
+        m_c_dy2 = sn * sn * ia + cs * cs * ib;
+
+        // vertical extent of the ellipse
+        double ext_y = std::sqrt(1 / (m_c_dy2 - m_b_dy * m_b_dy / (4 * m_a)));
+        y0 = std::max(0, cvCeil(m_center.y - ext_y));
+        y1 = std::min(size.height - 1, cvFloor(m_center.y + ext_y));
+    }
+
+    /// Finds span [x0, x1] of row y, returns false if it is empty.
+    bool span(int y, int& x0, int& x1) const
+    {
+        double dy = y - m_center.y;
+        double b = m_b_dy * dy;
+        double c = m_c_dy2 * dy * dy - 1;
+        double delta = b * b - 4 * m_a * c;
+        if (delta < 0)
+            return false;
+        double root = std::sqrt(delta);
+        x0 = std::max(0, cvCeil(m_center.x + (-b - root) / (2 * m_a)));
+        x1 = std::min(m_size.width - 1, cvFloor(m_center.x + (-b + root) / (2 * m_a)));
+        return x0 <= x1;
+    }
+
+private:
+    cv::Point2f m_center;
+    cv::Size m_size;
+    double m_a, m_b_dy, m_c_dy2;
+
+public:
+    /// Rows touched by the ellipse, empty if y0 > y1.
+    int y0, y1;
+};
+
+/// Adds \p counts of 8-bit values to \p bins bins spanning 0 .. \p range - 1, values above go to the last bin.
+void binCounts(const int* counts, int range, float scale, float* hist, int bins)
+{
+    for (int v = 0; v < 256; ++v)
+        hist[std::min(bins - 1, v * bins / range)] += counts[v] * scale;
+}
+
+}//: namespace
+
+void hueHistogram(const cv::Mat& hue, const cv::RotatedRect& ellipse, float* hist, int bins)
+{
+    CV_Assert(hue.type() == CV_8UC1 && bins > 0 && bins <= 256);
+
+    std::fill(hist, hist + bins, 0.0f);
+
+    EllipseSpans spans(ellipse, hue.size());
+
+    // four partial histograms, so that neighbouring pixels with the same
+    // bin don't wait for each other's increments
+    int counts[4][256] = { { 0 } };
+    int total = 0;
+
+    for (int y = spans.y0; y <= spans.y1; ++y) {
+        int x0, x1;
+        if (!spans.span(y, x0, x1))
+            continue;
+
+        const uchar* row = hue.ptr <uchar> (y);
+        int x = x0;
+        for (; x + 3 <= x1; x += 4) {
+            ++counts[0][row[x]];
+            ++counts[1][row[x + 1]];
+            ++counts[2][row[x + 2]];
+            ++counts[3][row[x + 3]];
+        }
+        for (; x <= x1; ++x)
+            ++counts[0][row[x]];
+        total += x1 - x0 + 1;
+    }
+
+    if (!total)
+        return;
+
+    for (int v = 0; v < 256; ++v)
+        counts[0][v] += counts[1][v] + counts[2][v] + counts[3][v];
+    binCounts(counts[0], 180, 1.0f / total, hist, bins);
+}
+
+void hueSatHistogram(const cv::Mat& hsv, const cv::RotatedRect& ellipse, float* hue_hist, int hue_bins,
+        float* sat_hist, int sat_bins)
+{
+    CV_Assert(hsv.type() == CV_8UC3 && hue_bins > 0 && hue_bins <= 256 && sat_bins > 0 && sat_bins <= 256);
+
+    std::fill(hue_hist, hue_hist + hue_bins, 0.0f);
+    std::fill(sat_hist, sat_hist + sat_bins, 0.0f);
+
+    EllipseSpans spans(ellipse, hsv.size());
+
+    // two partial histograms per channel, as in hueHistogram()
+    int hue_counts[2][256] = { { 0 } };
+    int sat_counts[2][256] = { { 0 } };
+    int total = 0;
+
+    for (int y = spans.y0; y <= spans.y1; ++y) {
+        int x0, x1;
+        if (!spans.span(y, x0, x1))
+            continue;
+
+        const uchar* p = hsv.ptr <uchar> (y) + 3 * x0;
+        const uchar* end = hsv.ptr <uchar> (y) + 3 * (x1 + 1);
+        for (; p + 6 <= end; p += 6) {
+            ++hue_counts[0][p[0]];
+            ++sat_counts[0][p[1]];
+            ++hue_counts[1][p[3]];
+            ++sat_counts[1][p[4]];
+        }
+        if (p < end) {
+            ++hue_counts[0][p[0]];
+            ++sat_counts[0][p[1]];
+        }
+        total += x1 - x0 + 1;
+    }
+
+    if (!total)
+        return;
+
+    for (int v = 0; v < 256; ++v) {
+        hue_counts[0][v] += hue_counts[1][v];
+        sat_counts[0][v] += sat_counts[1][v];
+    }
+    binCounts(hue_counts[0], 180, 1.0f / total, hue_hist, hue_bins);
+    binCounts(sat_counts[0], 256, 1.0f / total, sat_hist, sat_bins);
+}
+
+}//: namespace Blueball
+}//: namespace Types
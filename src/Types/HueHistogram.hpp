@@ -0,0 +1,42 @@
+/*!
+ * \file HueHistogram.hpp
+ * \brief Hue and saturation histograms of pixels inside an ellipse.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef HUE_HISTOGRAM_HPP_
+#define HUE_HISTOGRAM_HPP_
+
+#include <opencv2/core/core.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * Computes normalized histogram of OpenCV hue (0..179) of pixels inside
+ * \p ellipse, clipped to the image. Only spans of rows lying inside the
+ * ellipse are visited. Histogram is all zeros if no pixel falls inside.
+ *
+ * \param hue 8-bit single channel hue image
+ * \param hist output, \p bins values summing up to 1
+ */
+void hueHistogram(const cv::Mat& hue, const cv::RotatedRect& ellipse, float* hist, int bins);
+
+/*!
+ * Computes normalized hue and saturation histograms of pixels inside
+ * \p ellipse in one pass over the same row spans as hueHistogram().
+ * Histograms are kept separate rather than joint, so that a few bins of
+ * each stay populated on small blobs.
+ *
+ * \param hsv 8-bit three channel HSV image
+ * \param hue_hist output, \p hue_bins values summing up to 1
+ * \param sat_hist output, \p sat_bins values summing up to 1
+ */
+void hueSatHistogram(const cv::Mat& hsv, const cv::RotatedRect& ellipse, float* hue_hist, int hue_bins,
+        float* sat_hist, int sat_bins);
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* HUE_HISTOGRAM_HPP_ */
@@ -0,0 +1,89 @@
+/*!
+ * \file Mailbox.hpp
+ * \brief Single-slot mailbox passing the latest value between two threads.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef MAILBOX_HPP_
+#define MAILBOX_HPP_
+
+#include <boost/atomic.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class Mailbox
+ * \brief Triple buffer, the reader always gets the newest posted value.
+ *
+ * The writer fills back() and posts it, the reader takes it and reads
+ * front(). Each side owns one of three slots, the third one is swapped
+ * between them with a single atomic exchange of its index, so neither
+ * side ever waits or copies more than one value. A value posted before
+ * the previous one was taken replaces it - the newest one is never lost.
+ *
+ * One writer thread and one reader thread only.
+ */
+template <typename T>
+class Mailbox
+{
+public:
+    Mailbox() :
+        m_back(0), m_middle(1), m_front(2)
+    {
+    }
+
+    /// Slot to be filled by the writer.
+    T& back()
+    {
+        return m_slots[m_back];
+    }
+
+    /// Makes back() available to the reader, replacing a value it didn't take yet.
+    void post()
+    {
+        m_back = m_middle.exchange(m_back | Fresh) & ~Fresh;
+    }
+
+    /// Checks if a value was posted since the last take().
+    bool ready() const
+    {
+        return (m_middle.load() & Fresh) != 0;
+    }
+
+    /// Moves the newest posted value to front(), returns false if there is none.
+    bool take()
+    {
+        if (!ready())
+            return false;
+        m_front = m_middle.exchange(m_front) & ~Fresh;
+        return true;
+    }
+
+    /// Value taken by the reader.
+    const T& front() const
+    {
+        return m_slots[m_front];
+    }
+
+private:
+    /// Marks the middle slot as posted and not taken yet.
+    enum { Fresh = 4 };
+
+    T m_slots[3];
+
+    /// Slot of the writer, only touched by the writer.
+    int m_back;
+
+    /// Slot in between, with Fresh bit.
+    boost::atomic<int> m_middle;
+
+    /// Slot of the reader, only touched by the reader.
+    int m_front;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* MAILBOX_HPP_ */
@@ -0,0 +1,76 @@
+/*!
+ * \file MatPool.cpp
+ * \brief Pool of image buffers recycled between frames.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+
+#include <opencv2/core/version.hpp>
+
+#include "MatPool.hpp"
+
+namespace Types {
+namespace Blueball {
+
+MatPool::MatPool(int capacity) :
+    m_capacity(std::max(1, capacity)), m_next(0)
+{
+}
+
+void MatPool::setCapacity(int capacity)
+{
+    capacity = std::max(1, capacity);
+    if (capacity == m_capacity)
+        return;
+
+    m_capacity = capacity;
+    if ((int) m_buffers.size() > m_capacity)
+        m_buffers.resize(m_capacity);
+    m_next = 0;
+}
+
+void MatPool::clear()
+{
+    m_buffers.clear();
+    m_next = 0;
+}
+
+bool MatPool::isFree(const cv::Mat& buffer)
+{
+#if CV_MAJOR_VERSION < 3
+    return buffer.refcount && *buffer.refcount == 1;
+#else
+    return buffer.u && buffer.u->refcount == 1;
+#endif
+}
+
+cv::Mat MatPool::get(cv::Size size, int type)
+{
+    for (int i = 0; i < (int) m_buffers.size(); ++i) {
+        int slot = (m_next + i) % m_buffers.size();
+        if (isFree(m_buffers[slot])) {
+            m_next = (slot + 1) % m_capacity;
+            // create() reallocates only when size or type changed
+            m_buffers[slot].create(size, type);
+            return m_buffers[slot];
+        }
+    }
+
+    if ((int) m_buffers.size() < m_capacity) {
+        m_buffers.push_back(cv::Mat(size, type));
+        m_next = m_buffers.size() % m_capacity;
+        return m_buffers.back();
+    }
+
+    // every buffer is still read downstream - leave the oldest one
+    // to its readers and allocate a new one in its place
+    int slot = m_next;
+    m_buffers[slot] = cv::Mat(size, type);
+    m_next = (slot + 1) % m_capacity;
+    return m_buffers[slot];
+}
+
+}//: namespace Blueball
+}//: namespace Types
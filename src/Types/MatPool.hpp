@@ -0,0 +1,54 @@
+/*!
+ * \file MatPool.hpp
+ * \brief Pool of image buffers recycled between frames.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef MAT_POOL_HPP_
+#define MAT_POOL_HPP_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class MatPool
+ * \brief Ring of output buffers, reused only when nobody else holds them.
+ *
+ * Buffer returned by get() is not referenced anywhere outside the pool,
+ * so it can be overwritten without copying, while images written to data
+ * streams in previous frames stay intact for downstream components.
+ * When all buffers are still in use, the oldest one is left to its
+ * readers and replaced by a new allocation.
+ */
+class MatPool
+{
+public:
+    MatPool(int capacity = 3);
+
+    /// Changes number of buffers kept by the pool (at least 1).
+    void setCapacity(int capacity);
+
+    /// Returns buffer of given size and type, free to be overwritten.
+    cv::Mat get(cv::Size size, int type);
+
+    /// Drops all buffers.
+    void clear();
+
+private:
+    /// Checks if buffer is referenced only by the pool.
+    static bool isFree(const cv::Mat& buffer);
+
+    std::vector<cv::Mat> m_buffers;
+    int m_capacity;
+    int m_next;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* MAT_POOL_HPP_ */
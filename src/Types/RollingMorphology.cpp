@@ -0,0 +1,241 @@
+/*!
+ * \file RollingMorphology.cpp
+ * \brief Row-streaming morphology on 8-bit masks.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include "RollingMorphology.hpp"
+
+namespace Types {
+namespace Blueball {
+
+namespace {
+
+struct MaxOp
+{
+    static uchar apply(uchar a, uchar b)
+    {
+        return std::max(a, b);
+    }
+};
+
+struct MinOp
+{
+    static uchar apply(uchar a, uchar b)
+    {
+        return std::min(a, b);
+    }
+};
+
+template <class Op>
+void combine(const uchar* a, const uchar* b, uchar* dst, int width)
+{
+    for (int x = 0; x < width; ++x)
+        dst[x] = Op::apply(a[x], b[x]);
+}
+
+/*!
+ * Extremum over window [lo, hi] of at most \p block elements, from prefix
+ * and suffix extrema of blocks. Window ends are clipped to the data.
+ */
+template <class Op>
+uchar windowValue(const uchar* prefix, const uchar* suffix, int lo, int hi, int block)
+{
+    if (lo / block != hi / block)
+        return Op::apply(suffix[lo], prefix[hi]);
+    // window inside one block touches its start or its (truncated) end
+    return (lo % block == 0) ? prefix[hi] : suffix[lo];
+}
+
+/*!
+ * van Herk/Gil-Werman filter of one row with window 2 * radius + 1.
+ */
+template <class Op>
+void filterRow(const uchar* src, uchar* dst, uchar* prefix, uchar* suffix, int width, int radius)
+{
+    int block = 2 * radius + 1;
+
+    for (int b = 0; b < width; b += block) {
+        int e = std::min(width, b + block) - 1;
+        prefix[b] = src[b];
+        for (int x = b + 1; x <= e; ++x)
+            prefix[x] = Op::apply(prefix[x - 1], src[x]);
+        suffix[e] = src[e];
+        for (int x = e - 1; x >= b; --x)
+            suffix[x] = Op::apply(suffix[x + 1], src[x]);
+    }
+
+    // full windows always combine suffix of one block with prefix of the next one
+    int x0 = std::min(radius, width);
+    int x1 = std::max(x0, width - radius);
+    for (int x = 0; x < x0; ++x)
+        dst[x] = windowValue<Op> (prefix, suffix, std::max(0, x - radius), std::min(width - 1, x + radius), block);
+    for (int x = x0; x < x1; ++x)
+        dst[x] = Op::apply(suffix[x - radius], prefix[x + radius]);
+    for (int x = x1; x < width; ++x)
+        dst[x] = windowValue<Op> (prefix, suffix, std::max(0, x - radius), std::min(width - 1, x + radius), block);
+}
+
+}
+
+RollingMinMax::RollingMinMax() :
+    m_dilate(true), m_radius(0), m_block(1), m_ring(2), m_width(0), m_height(0), m_in(0), m_out(0)
+{
+}
+
+void RollingMinMax::create(bool dilate, int radius, cv::Size size)
+{
+    m_dilate = dilate;
+    m_radius = std::max(0, radius);
+    m_block = 2 * m_radius + 1;
+    m_ring = 2 * m_block;
+    m_width = size.width;
+    m_height = size.height;
+    m_in = m_out = 0;
+
+    m_rows.resize(m_ring * m_width);
+    m_prefix.resize(m_ring * m_width);
+    m_suffix.resize(m_ring * m_width);
+    m_row_prefix.resize(m_width);
+    m_row_suffix.resize(m_width);
+    m_output.resize(m_width);
+}
+
+void RollingMinMax::push(const uchar* row)
+{
+    // outputs ready before this row must have been popped
+    CV_Assert(m_in < m_height && std::min(m_height - 1, m_out + m_radius) >= m_in);
+
+    int y = m_in;
+    uchar* dst = slot(m_rows, y);
+    uchar* prefix = slot(m_prefix, y);
+
+    if (m_dilate) {
+        filterRow<MaxOp> (row, dst, &m_row_prefix[0], &m_row_suffix[0], m_width, m_radius);
+        if (y % m_block)
+            combine<MaxOp> (slot(m_prefix, y - 1), dst, prefix, m_width);
+    } else {
+        filterRow<MinOp> (row, dst, &m_row_prefix[0], &m_row_suffix[0], m_width, m_radius);
+        if (y % m_block)
+            combine<MinOp> (slot(m_prefix, y - 1), dst, prefix, m_width);
+    }
+    if (y % m_block == 0)
+        memcpy(prefix, dst, m_width);
+
+    if (y % m_block == m_block - 1 || y == m_height - 1)
+        closeBlock(y);
+
+    ++m_in;
+}
+
+void RollingMinMax::closeBlock(int end)
+{
+    int begin = end - end % m_block;
+    memcpy(slot(m_suffix, end), slot(m_rows, end), m_width);
+    for (int y = end - 1; y >= begin; --y) {
+        if (m_dilate)
+            combine<MaxOp> (slot(m_suffix, y + 1), slot(m_rows, y), slot(m_suffix, y), m_width);
+        else
+            combine<MinOp> (slot(m_suffix, y + 1), slot(m_rows, y), slot(m_suffix, y), m_width);
+    }
+}
+
+const uchar* RollingMinMax::pop()
+{
+    int y = m_out;
+    if (y >= m_height)
+        return NULL;
+
+    int lo = std::max(0, y - m_radius);
+    int hi = std::min(m_height - 1, y + m_radius);
+    if (hi >= m_in)
+        return NULL;
+
+    ++m_out;
+
+    // same rules as windowValue, applied to whole rows
+    if (lo / m_block == hi / m_block)
+        return (lo % m_block == 0) ? slot(m_prefix, hi) : slot(m_suffix, lo);
+
+    if (m_dilate)
+        combine<MaxOp> (slot(m_suffix, lo), slot(m_prefix, hi), &m_output[0], m_width);
+    else
+        combine<MinOp> (slot(m_suffix, lo), slot(m_prefix, hi), &m_output[0], m_width);
+    return &m_output[0];
+}
+
+RollingMorphology::RollingMorphology() :
+    m_pending(NULL), m_in(0)
+{
+}
+
+void RollingMorphology::create(cv::Size size, int close_iterations, int open_iterations)
+{
+    close_iterations = std::max(0, close_iterations);
+    open_iterations = std::max(0, open_iterations);
+
+    // dilate(c) erode(c) erode(o) dilate(o), both erosions with one filter
+    m_stages.clear();
+    RollingMinMax stage;
+    if (close_iterations > 0) {
+        stage.create(true, close_iterations, size);
+        m_stages.push_back(stage);
+    }
+    if (close_iterations + open_iterations > 0) {
+        stage.create(false, close_iterations + open_iterations, size);
+        m_stages.push_back(stage);
+    }
+    if (open_iterations > 0) {
+        stage.create(true, open_iterations, size);
+        m_stages.push_back(stage);
+    }
+
+    m_pending = NULL;
+    m_in = 0;
+}
+
+void RollingMorphology::push(const uchar* row)
+{
+    if (m_stages.empty())
+        m_pending = row;
+    else
+        m_stages[0].push(row);
+    ++m_in;
+}
+
+const uchar* RollingMorphology::pop()
+{
+    if (m_stages.empty()) {
+        const uchar* row = m_pending;
+        m_pending = NULL;
+        return row;
+    }
+    return pop(m_stages.size() - 1);
+}
+
+const uchar* RollingMorphology::pop(int i)
+{
+    for (;;) {
+        const uchar* row = m_stages[i].pop();
+        if (row || i == 0)
+            return row;
+
+        // stage is drained, give it one more row
+        row = pop(i - 1);
+        if (!row)
+            return NULL;
+        m_stages[i].push(row);
+    }
+}
+
+int RollingMorphology::lastRow() const
+{
+    return m_stages.empty() ? m_in - 1 : m_stages.back().lastRow();
+}
+
+}//: namespace Blueball
+}//: namespace Types
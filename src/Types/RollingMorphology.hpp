@@ -0,0 +1,121 @@
+/*!
+ * \file RollingMorphology.hpp
+ * \brief Row-streaming morphology on 8-bit masks.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef ROLLING_MORPHOLOGY_HPP_
+#define ROLLING_MORPHOLOGY_HPP_
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class RollingMinMax
+ * \brief Square min/max filter fed row by row.
+ *
+ * Both passes use van Herk/Gil-Werman prefix/suffix maxima over blocks
+ * of 2 * radius + 1 pixels, so the cost per pixel doesn't depend on the
+ * radius. Only 2 * (2 * radius + 1) rows are kept. Pixels outside the
+ * image are ignored, as in cv::erode/cv::dilate with default border.
+ */
+class RollingMinMax
+{
+public:
+    RollingMinMax();
+
+    /// Prepares filter for image of given size, \p dilate selects max (true) or min (false).
+    void create(bool dilate, int radius, cv::Size size);
+
+    /// Adds the next input row.
+    void push(const uchar* row);
+
+    /*!
+     * Returns the next output row, or NULL if it needs more input. Output
+     * must be drained after each push, returned row is valid until the
+     * next call.
+     */
+    const uchar* pop();
+
+    /// Index of the row returned by the last pop.
+    int lastRow() const
+    {
+        return m_out - 1;
+    }
+
+private:
+    uchar* slot(std::vector<uchar>& buf, int y)
+    {
+        return &buf[(y % m_ring) * m_width];
+    }
+
+    /// Computes suffix extrema of block ending at row \p end.
+    void closeBlock(int end);
+
+    bool m_dilate;
+    int m_radius;
+    int m_block;
+    int m_ring;
+    int m_width;
+    int m_height;
+
+    /// Rows pushed and popped so far.
+    int m_in;
+    int m_out;
+
+    /// Horizontally filtered rows, their block prefix and suffix extrema.
+    std::vector<uchar> m_rows;
+    std::vector<uchar> m_prefix;
+    std::vector<uchar> m_suffix;
+
+    /// Scratch for the horizontal pass and the output row.
+    std::vector<uchar> m_row_prefix;
+    std::vector<uchar> m_row_suffix;
+    std::vector<uchar> m_output;
+};
+
+/*!
+ * \class RollingMorphology
+ * \brief Closing followed by opening, computed in one pass over the rows.
+ *
+ * Equivalent to cv::morphologyEx with MORPH_CLOSE and then MORPH_OPEN,
+ * default 3x3 kernel and given iterations. Erosions of both operations
+ * are merged, so at most three RollingMinMax stages are chained.
+ */
+class RollingMorphology
+{
+public:
+    RollingMorphology();
+
+    /// Prepares pipeline for image of given size.
+    void create(cv::Size size, int close_iterations, int open_iterations);
+
+    /// Adds the next input row.
+    void push(const uchar* row);
+
+    /// Returns the next cleaned row or NULL, same rules as RollingMinMax::pop.
+    const uchar* pop();
+
+    /// Index of the row returned by the last pop.
+    int lastRow() const;
+
+private:
+    /// Pops output of stage \p i, feeding the earlier stages as needed.
+    const uchar* pop(int i);
+
+    std::vector<RollingMinMax> m_stages;
+
+    /// Row pushed when there are no stages.
+    const uchar* m_pending;
+    int m_in;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* ROLLING_MORPHOLOGY_HPP_ */
@@ -0,0 +1,299 @@
+/*!
+ * \file Runs.cpp
+ * \brief Run-length representation of binary masks and run-based blob labeling.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include "Runs.hpp"
+
+namespace Types {
+namespace Blueball {
+
+namespace {
+
+inline int ctz(uint64_t x)
+{
+    return __builtin_ctzll(x);
+}
+
+bool largerArea(const RunBlob& a, const RunBlob& b)
+{
+    return a.area() > b.area();
+}
+
+}
+
+double RawMoments::central(int p, int q) const
+{
+    if (m00 <= 0)
+        return 0;
+
+    double cx = m10 / m00;
+    double cy = m01 / m00;
+
+    switch (p * 4 + q) {
+    case 0:  return m00;
+    case 1:
+    case 4:  return 0;
+    case 8:  return m20 - cx * m10;
+    case 2:  return m02 - cy * m01;
+    case 5:  return m11 - cx * m01;
+    case 12: return m30 - 3 * cx * m20 + 2 * cx * cx * m10;
+    case 3:  return m03 - 3 * cy * m02 + 2 * cy * cy * m01;
+    case 9:  return m21 - 2 * cx * m11 - cy * m20 + 2 * cx * cx * m01;
+    case 6:  return m12 - 2 * cy * m11 - cx * m02 + 2 * cy * cy * m10;
+    default: return 0;
+    }
+}
+
+void extractRuns(const uint64_t* words, int width, std::vector<Run>& runs)
+{
+    int stride = (width + 63) / 64;
+    bool in_run = false;
+    Run run;
+    run.x0 = 0;
+    for (int k = 0; k < stride; ++k) {
+        uint64_t w = words[k];
+        int pos = 0;
+        while (pos < 64) {
+            // look for the next bit that differs from the current state
+            uint64_t rest = (in_run ? ~w : w) >> pos;
+            if (!rest)
+                break;
+            pos += ctz(rest);
+            if (in_run) {
+                run.x1 = 64 * k + pos;
+                runs.push_back(run);
+            } else {
+                run.x0 = 64 * k + pos;
+            }
+            in_run = !in_run;
+        }
+    }
+    if (in_run) {
+        run.x1 = width;
+        runs.push_back(run);
+    }
+}
+
+void extractRuns(const uchar* row, int width, int offset, std::vector<Run>& runs)
+{
+    Run run;
+    int x = 0;
+    while (x < width) {
+        // skip background 8 pixels at a time
+        while (x + 8 <= width) {
+            uint64_t chunk;
+            memcpy(&chunk, row + x, sizeof(chunk));
+            if (chunk)
+                break;
+            x += 8;
+        }
+        while (x < width && !row[x])
+            ++x;
+        if (x >= width)
+            break;
+
+        run.x0 = x + offset;
+        while (x < width && row[x])
+            ++x;
+        run.x1 = x + offset;
+        runs.push_back(run);
+    }
+}
+
+void encodeRuns(const cv::Mat& mask, const cv::Rect& roi, RunMask& runs)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+
+    runs.size = mask.size();
+    runs.runs.clear();
+    runs.rows.assign(mask.rows + 1, 0);
+
+    for (int y = roi.y; y < roi.y + roi.height; ++y) {
+        runs.rows[y] = runs.runs.size();
+        extractRuns(mask.ptr <uchar> (y) + roi.x, roi.width, roi.x, runs.runs);
+    }
+    // rows below the region are empty
+    for (int y = roi.y + roi.height; y <= mask.rows; ++y)
+        runs.rows[y] = runs.runs.size();
+}
+
+void encodeRuns(const cv::Mat& mask, const std::vector<cv::Rect>& regions, RunMask& runs)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+
+    runs.size = mask.size();
+    runs.runs.clear();
+    runs.rows.resize(mask.rows + 1);
+
+    // regions are disjoint and sorted by x, so runs of a row stay sorted
+    for (int y = 0; y < mask.rows; ++y) {
+        runs.rows[y] = runs.runs.size();
+        for (size_t i = 0; i < regions.size(); ++i) {
+            const cv::Rect& r = regions[i];
+            if (y >= r.y && y < r.y + r.height)
+                extractRuns(mask.ptr <uchar> (y) + r.x, r.width, r.x, runs.runs);
+        }
+    }
+    runs.rows[mask.rows] = runs.runs.size();
+}
+
+void labelRuns(const RunMask& runs, RunLabeler& labeler)
+{
+    for (int y = 0; y < runs.size.height; ++y) {
+        int count = runs.count(y);
+        if (count)
+            labeler.addRow(y, runs.row(y), count);
+    }
+}
+
+int matchBlob(const RunBlobs& blobs, const cv::Rect& bbox, double area)
+{
+    double tolerance = bbox.width + bbox.height;
+    int best = -1;
+    double best_difference = 0;
+    for (int i = 0; i < (int) blobs.size(); ++i) {
+        const cv::Rect& r = blobs[i].bbox;
+        if (std::abs(r.x - bbox.x) > 1 || std::abs(r.y - bbox.y) > 1
+                || std::abs(r.x + r.width - bbox.x - bbox.width) > 1
+                || std::abs(r.y + r.height - bbox.y - bbox.height) > 1)
+            continue;
+
+        double difference = std::fabs(blobs[i].area() - area);
+        if (difference <= tolerance && (best < 0 || difference < best_difference)) {
+            best = i;
+            best_difference = difference;
+        }
+    }
+    return best;
+}
+
+RunLabeler::RunLabeler()
+{
+    reset();
+}
+
+void RunLabeler::reset()
+{
+    m_parent.clear();
+    m_blobs.clear();
+    m_prev_runs.clear();
+    m_prev_labels.clear();
+    m_prev_y = -2;
+}
+
+int RunLabeler::find(int label)
+{
+    int root = label;
+    while (m_parent[root] != root)
+        root = m_parent[root];
+    // path compression
+    while (m_parent[label] != root) {
+        int next = m_parent[label];
+        m_parent[label] = root;
+        label = next;
+    }
+    return root;
+}
+
+int RunLabeler::newLabel()
+{
+    int label = m_parent.size();
+    m_parent.push_back(label);
+    m_blobs.push_back(RunBlob());
+    return label;
+}
+
+void RunLabeler::accumulate(int label, int y, const Run& run)
+{
+    RunBlob& blob = m_blobs[label];
+    blob.moments.addRun(y, run.x0, run.x1);
+    cv::Rect r(run.x0, y, run.x1 - run.x0, 1);
+    if (blob.bbox.width == 0)
+        blob.bbox = r;
+    else
+        blob.bbox |= r;
+}
+
+void RunLabeler::addRow(int y, const Run* runs, int count)
+{
+    bool adjacent = (y == m_prev_y + 1);
+    m_labels.resize(count);
+
+    size_t p = 0;
+    for (int i = 0; i < count; ++i) {
+        const Run& run = runs[i];
+        int label = -1;
+
+        if (adjacent) {
+            // skip runs of the previous row ending before this one
+            // (8-connectivity - diagonal neighbours touch)
+            while (p < m_prev_runs.size() && m_prev_runs[p].x1 < run.x0)
+                ++p;
+            for (size_t q = p; q < m_prev_runs.size() && m_prev_runs[q].x0 <= run.x1; ++q) {
+                int other = find(m_prev_labels[q]);
+                if (label < 0) {
+                    label = other;
+                } else if (other != label) {
+                    // keep the smaller label as root
+                    if (other < label)
+                        std::swap(other, label);
+                    m_parent[other] = label;
+                }
+            }
+        }
+
+        if (label < 0)
+            label = newLabel();
+
+        accumulate(label, y, run);
+        m_labels[i] = label;
+    }
+
+    m_prev_runs.assign(runs, runs + count);
+    m_prev_labels.swap(m_labels);
+    m_prev_y = y;
+}
+
+void RunLabeler::addMask(const cv::Mat& mask, const cv::Rect& region)
+{
+    CV_Assert(mask.type() == CV_8UC1);
+
+    for (int y = region.y; y < region.y + region.height; ++y) {
+        m_row_runs.clear();
+        extractRuns(mask.ptr <uchar> (y) + region.x, region.width, region.x, m_row_runs);
+        if (!m_row_runs.empty())
+            addRow(y, &m_row_runs[0], m_row_runs.size());
+    }
+}
+
+void RunLabeler::finish(RunBlobs& blobs, double min_area)
+{
+    // merge partial results into roots
+    for (int label = 0; label < (int) m_parent.size(); ++label) {
+        int root = find(label);
+        if (root == label)
+            continue;
+        m_blobs[root].moments.add(m_blobs[label].moments);
+        m_blobs[root].bbox |= m_blobs[label].bbox;
+    }
+
+    blobs.clear();
+    for (int label = 0; label < (int) m_parent.size(); ++label) {
+        if (m_parent[label] == label && m_blobs[label].area() >= min_area)
+            blobs.push_back(m_blobs[label]);
+    }
+    std::sort(blobs.begin(), blobs.end(), largerArea);
+
+    reset();
+}
+
+}//: namespace Blueball
+}//: namespace Types
@@ -0,0 +1,206 @@
+/*!
+ * \file Runs.hpp
+ * \brief Run-length representation of binary masks and run-based blob labeling.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef RUNS_HPP_
+#define RUNS_HPP_
+
+#include <stdint.h>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include <opencv2/core/core.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \struct Run
+ * \brief Horizontal segment [x0, x1) of foreground pixels in a row.
+ */
+struct Run
+{
+    int x0;
+    int x1;
+};
+
+/*!
+ * \struct RawMoments
+ * \brief Raw moments m_pq = sum(x^p * y^q) up to the third order.
+ */
+struct RawMoments
+{
+    double m00, m10, m01, m11, m20, m02;
+    double m30, m21, m12, m03;
+
+    RawMoments()
+    {
+        m00 = m10 = m01 = m11 = m20 = m02 = 0;
+        m30 = m21 = m12 = m03 = 0;
+    }
+
+    /// Adds pixels [x0, x1) of row y, sums over x are in closed form.
+    void addRun(int y, int x0, int x1)
+    {
+        double n = x1 - x0;
+        double a = x0 - 1, b = x1 - 1;
+        double sx = 0.5 * (b * (b + 1) - a * (a + 1));
+        double sxx = (b * (b + 1) * (2 * b + 1) - a * (a + 1) * (2 * a + 1)) / 6;
+        double sb = 0.5 * b * (b + 1), sa = 0.5 * a * (a + 1);
+        double sxxx = sb * sb - sa * sa;
+        double yy = (double) y * y;
+        m00 += n;
+        m10 += sx;
+        m01 += n * y;
+        m11 += sx * y;
+        m20 += sxx;
+        m02 += n * yy;
+        m30 += sxxx;
+        m21 += sxx * y;
+        m12 += sx * yy;
+        m03 += n * yy * y;
+    }
+
+    void add(const RawMoments& other)
+    {
+        m00 += other.m00;
+        m10 += other.m10;
+        m01 += other.m01;
+        m11 += other.m11;
+        m20 += other.m20;
+        m02 += other.m02;
+        m30 += other.m30;
+        m21 += other.m21;
+        m12 += other.m12;
+        m03 += other.m03;
+    }
+
+    /// Central moment mu_pq, for p + q <= 3.
+    double central(int p, int q) const;
+};
+
+/*!
+ * \struct RunBlob
+ * \brief Connected component described by its moments and bounding box.
+ */
+struct RunBlob
+{
+    RawMoments moments;
+    cv::Rect bbox;
+
+    double area() const
+    {
+        return moments.m00;
+    }
+};
+
+/// Blobs ordered from the largest one.
+typedef std::vector<RunBlob> RunBlobs;
+
+/// Blobs as passed through data streams, shared by readers instead of copied.
+typedef boost::shared_ptr<const RunBlobs> SharedRunBlobs;
+
+/*!
+ * \struct RunMask
+ * \brief Binary mask stored as runs of foreground pixels, row by row.
+ *
+ * Runs of row y are runs[rows[y]] .. runs[rows[y + 1] - 1].
+ */
+struct RunMask
+{
+    cv::Size size;
+    std::vector<int> rows;
+    std::vector<Run> runs;
+
+    /// Number of runs in row y.
+    int count(int y) const
+    {
+        return rows[y + 1] - rows[y];
+    }
+
+    /// First run of row y, valid only if the row has any runs.
+    const Run* row(int y) const
+    {
+        return &runs[rows[y]];
+    }
+};
+
+/// Mask as passed through data streams, shared by readers instead of copied.
+typedef boost::shared_ptr<const RunMask> SharedRunMask;
+
+/// Appends runs of a packed row (see BitMask) to \p runs.
+void extractRuns(const uint64_t* words, int width, std::vector<Run>& runs);
+
+/// Appends runs of nonzero pixels of a byte row to \p runs, shifted by \p offset.
+void extractRuns(const uchar* row, int width, int offset, std::vector<Run>& runs);
+
+/// Encodes nonzero pixels of \p roi region of 8-bit mask, rest of the mask is assumed empty.
+void encodeRuns(const cv::Mat& mask, const cv::Rect& roi, RunMask& runs);
+
+/// Encodes nonzero pixels of \p regions of 8-bit mask. Regions must not touch and must be sorted by x.
+void encodeRuns(const cv::Mat& mask, const std::vector<cv::Rect>& regions, RunMask& runs);
+
+/*!
+ * \class RunLabeler
+ * \brief Streaming 8-connected component labeling over runs.
+ *
+ * Rows are fed top to bottom, only runs of the previous row are kept.
+ * Labels are merged with union-find and moments are accumulated per
+ * label, so no label image is ever created.
+ */
+class RunLabeler
+{
+public:
+    RunLabeler();
+
+    /// Forgets all rows.
+    void reset();
+
+    /// Adds runs of row y. Rows must come in increasing order, runs sorted by x0.
+    void addRow(int y, const Run* runs, int count);
+
+    /// Adds rows of \p region of 8-bit mask, nonzero pixels are foreground.
+    void addMask(const cv::Mat& mask, const cv::Rect& region);
+
+    /// Returns blobs of at least \p min_area pixels, the largest first.
+    void finish(RunBlobs& blobs, double min_area = 0);
+
+private:
+    int find(int label);
+
+    int newLabel();
+
+    void accumulate(int label, int y, const Run& run);
+
+    std::vector<int> m_parent;
+    std::vector<RunBlob> m_blobs;
+
+    std::vector<Run> m_prev_runs;
+    std::vector<int> m_prev_labels;
+    std::vector<int> m_labels;
+    int m_prev_y;
+
+    /// Runs of a mask row, used by addMask.
+    std::vector<Run> m_row_runs;
+};
+
+/// Feeds all rows of \p runs into \p labeler.
+void labelRuns(const RunMask& runs, RunLabeler& labeler);
+
+/*!
+ * Finds blob found by another labeling (e.g. CvBlobs) among \p blobs.
+ * Each edge of the bounding box may differ by one pixel and the area by
+ * half the box perimeter, as contour-based areas leave out part of the
+ * border pixels. Of several such blobs the one closest in area is chosen.
+ * \returns index of the blob, -1 if none matches.
+ */
+int matchBlob(const RunBlobs& blobs, const cv::Rect& bbox, double area);
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* RUNS_HPP_ */
@@ -0,0 +1,89 @@
+/*!
+ * \file SearchWindow.cpp
+ * \brief Region of interest predicted from the last known ball position.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "SearchWindow.hpp"
+
+namespace Types {
+namespace Blueball {
+
+cv::Rect clampRoi(const cv::Rect& roi, const cv::Size& frame)
+{
+    cv::Rect full(0, 0, frame.width, frame.height);
+    cv::Rect clamped = roi & full;
+    if (clamped.width <= 0 || clamped.height <= 0)
+        return full;
+    return clamped;
+}
+
+void clearOutside(cv::Mat& img, const cv::Rect& roi)
+{
+    if (roi.y > 0)
+        img.rowRange(0, roi.y).setTo(cv::Scalar::all(0));
+    if (roi.y + roi.height < img.rows)
+        img.rowRange(roi.y + roi.height, img.rows).setTo(cv::Scalar::all(0));
+
+    cv::Mat rows = img.rowRange(roi.y, roi.y + roi.height);
+    if (roi.x > 0)
+        rows.colRange(0, roi.x).setTo(cv::Scalar::all(0));
+    if (roi.x + roi.width < img.cols)
+        rows.colRange(roi.x + roi.width, img.cols).setTo(cv::Scalar::all(0));
+}
+
+SearchWindow::SearchWindow() :
+    m_tracking(false), m_misses(0), m_margin(2.0), m_max_misses(3), m_min_size(32)
+{
+}
+
+void SearchWindow::reset()
+{
+    m_tracking = false;
+    m_misses = 0;
+    m_velocity = cv::Point2f(0, 0);
+}
+
+cv::Rect SearchWindow::found(const cv::Point2f& center, const cv::Size2f& size, const cv::Size& frame)
+{
+    m_velocity = m_tracking ? (center - m_center) * (1.0f / (m_misses + 1)) : cv::Point2f(0, 0);
+    m_center = center;
+    m_size = size;
+    m_tracking = true;
+    m_misses = 0;
+
+    return window(frame);
+}
+
+cv::Rect SearchWindow::missed(const cv::Size& frame)
+{
+    if (!m_tracking || ++m_misses > m_max_misses) {
+        reset();
+        return cv::Rect();
+    }
+
+    return window(frame);
+}
+
+cv::Rect SearchWindow::window(const cv::Size& frame) const
+{
+    // predicted position after all frames since last detection
+    float steps = (float) (m_misses + 1);
+    cv::Point2f predicted = m_center + m_velocity * steps;
+
+    // uncertainty grows with each missed frame
+    double scale = m_margin * steps;
+    double half_w = std::max(0.5 * m_min_size, 0.5 * m_size.width * scale + std::fabs(m_velocity.x) * steps);
+    double half_h = std::max(0.5 * m_min_size, 0.5 * m_size.height * scale + std::fabs(m_velocity.y) * steps);
+
+    cv::Rect roi(cvFloor(predicted.x - half_w), cvFloor(predicted.y - half_h),
+            cvCeil(2 * half_w), cvCeil(2 * half_h));
+    return roi & cv::Rect(0, 0, frame.width, frame.height);
+}
+
+}//: namespace Blueball
+}//: namespace Types
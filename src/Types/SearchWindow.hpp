@@ -0,0 +1,84 @@
+/*!
+ * \file SearchWindow.hpp
+ * \brief Region of interest predicted from the last known ball position.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef SEARCH_WINDOW_HPP_
+#define SEARCH_WINDOW_HPP_
+
+#include <opencv2/core/core.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * Returns part of \p roi lying inside the frame. Empty rectangle
+ * (or one lying outside of the frame) selects the whole frame.
+ */
+cv::Rect clampRoi(const cv::Rect& roi, const cv::Size& frame);
+
+/// Zeroes all pixels of \p img lying outside of \p roi.
+void clearOutside(cv::Mat& img, const cv::Rect& roi);
+
+/*!
+ * \class SearchWindow
+ * \brief Predicts where to look for the ball in the next frame.
+ *
+ * Ball is assumed to move with constant velocity. Window is the ball's
+ * bounding box scaled by margin, grown by the predicted displacement.
+ * Every missed frame grows the window further, after max_misses misses
+ * in a row it returns empty rectangle, i.e. full frame search.
+ */
+class SearchWindow
+{
+public:
+    SearchWindow();
+
+    /// Ratio of window size to ball size.
+    void setMargin(double margin)
+    {
+        m_margin = margin;
+    }
+
+    /// Number of missed frames after which the whole frame is searched.
+    void setMaxMisses(int max_misses)
+    {
+        m_max_misses = max_misses;
+    }
+
+    /// Minimal window side, in pixels.
+    void setMinSize(int min_size)
+    {
+        m_min_size = min_size;
+    }
+
+    /// Ball found at \p center with bounding box \p size - returns window for the next frame.
+    cv::Rect found(const cv::Point2f& center, const cv::Size2f& size, const cv::Size& frame);
+
+    /// Ball not found - returns window for the next frame.
+    cv::Rect missed(const cv::Size& frame);
+
+    /// Forgets the ball, next window will cover whole frame.
+    void reset();
+
+private:
+    cv::Rect window(const cv::Size& frame) const;
+
+    bool m_tracking;
+    int m_misses;
+
+    cv::Point2f m_center;
+    cv::Point2f m_velocity;
+    cv::Size2f m_size;
+
+    double m_margin;
+    int m_max_misses;
+    int m_min_size;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* SEARCH_WINDOW_HPP_ */
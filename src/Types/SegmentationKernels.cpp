@@ -0,0 +1,196 @@
+/*!
+ * \file SegmentationKernels.cpp
+ * \brief Row kernels thresholding interleaved HSV pixels into a binary mask.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include "SegmentationKernels.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BLUEBALL_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace Types {
+namespace Blueball {
+
+static inline uchar clampByte(int x)
+{
+    return (uchar) (x < 0 ? 0 : (x > 255 ? 255 : x));
+}
+
+HSVThresholds makeThresholds(int hue_lo, int hue_hi, int sat_lo, int val_lo)
+{
+    HSVThresholds thr;
+    thr.hue_lo = clampByte(hue_lo);
+    thr.hue_hi = clampByte(hue_hi);
+    thr.sat_lo = clampByte(sat_lo);
+    thr.val_lo = clampByte(val_lo);
+    return thr;
+}
+
+void segmentRowScalar(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr)
+{
+    for (int j = 0; j < width; ++j, hsv += 3) {
+        uchar hue = hsv[0];
+        uchar sat = hsv[1];
+        uchar val = hsv[2];
+
+        // label colors, exclude undersaturated areas (gray levels)
+        // and too dark areas
+        bool blue = (hue >= thr.hue_lo) & (hue < thr.hue_hi) & (sat >= thr.sat_lo) & (val >= thr.val_lo);
+        seg[j] = blue ? 255 : 0;
+    }
+}
+
+#ifdef BLUEBALL_X86_KERNELS
+
+// Shuffle masks gathering H, S and V bytes of 16 interleaved pixels
+// spread over three consecutive 16-byte blocks (a, b, c).
+#define SHUFFLE_MASKS \
+    const __m128i h_a = _mm_setr_epi8( 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1); \
+    const __m128i h_b = _mm_setr_epi8(-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14,-1,-1,-1,-1,-1); \
+    const __m128i h_c = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 1, 4, 7,10,13); \
+    const __m128i s_a = _mm_setr_epi8( 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1); \
+    const __m128i s_b = _mm_setr_epi8(-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15,-1,-1,-1,-1,-1); \
+    const __m128i s_c = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 2, 5, 8,11,14); \
+    const __m128i v_a = _mm_setr_epi8( 2, 5, 8,11,14,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1,-1); \
+    const __m128i v_b = _mm_setr_epi8(-1,-1,-1,-1,-1, 1, 4, 7,10,13,-1,-1,-1,-1,-1,-1); \
+    const __m128i v_c = _mm_setr_epi8(-1,-1,-1,-1,-1,-1,-1,-1,-1,-1, 0, 3, 6, 9,12,15)
+
+__attribute__((target("sse4.1")))
+void segmentRowSSE41(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr)
+{
+    SHUFFLE_MASKS;
+
+    const __m128i hue_lo = _mm_set1_epi8((char) thr.hue_lo);
+    const __m128i hue_hi = _mm_set1_epi8((char) thr.hue_hi);
+    const __m128i sat_lo = _mm_set1_epi8((char) thr.sat_lo);
+    const __m128i val_lo = _mm_set1_epi8((char) thr.val_lo);
+
+    int j = 0;
+    for (; j + 16 <= width; j += 16, hsv += 48) {
+        __m128i a = _mm_loadu_si128((const __m128i*) hsv);
+        __m128i b = _mm_loadu_si128((const __m128i*) (hsv + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*) (hsv + 32));
+
+        __m128i h = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, h_a), _mm_shuffle_epi8(b, h_b)), _mm_shuffle_epi8(c, h_c));
+        __m128i s = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, s_a), _mm_shuffle_epi8(b, s_b)), _mm_shuffle_epi8(c, s_c));
+        __m128i v = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, v_a), _mm_shuffle_epi8(b, v_b)), _mm_shuffle_epi8(c, v_c));
+
+        // unsigned x >= t <=> max(x, t) == x
+        __m128i m = _mm_cmpeq_epi8(_mm_max_epu8(h, hue_lo), h);
+        m = _mm_and_si128(m, _mm_cmpeq_epi8(_mm_max_epu8(s, sat_lo), s));
+        m = _mm_and_si128(m, _mm_cmpeq_epi8(_mm_max_epu8(v, val_lo), v));
+        m = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_max_epu8(h, hue_hi), h), m);
+
+        _mm_storeu_si128((__m128i*) (seg + j), m);
+    }
+
+    segmentRowScalar(hsv, seg + j, width - j, thr);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i loadLanes(const uchar* lo, const uchar* hi)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i*) lo)),
+            _mm_loadu_si128((const __m128i*) hi), 1);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i broadcastLanes(__m128i x)
+{
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(x), x, 1);
+}
+
+__attribute__((target("avx2")))
+void segmentRowAVX2(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr)
+{
+    SHUFFLE_MASKS;
+
+    // _mm256_shuffle_epi8 works within 128-bit lanes, so lower lane holds
+    // pixels 0..15 and upper lane pixels 16..31 of the block, which lets
+    // both lanes reuse the SSE shuffle masks.
+    const __m256i h_a2 = broadcastLanes(h_a), h_b2 = broadcastLanes(h_b), h_c2 = broadcastLanes(h_c);
+    const __m256i s_a2 = broadcastLanes(s_a), s_b2 = broadcastLanes(s_b), s_c2 = broadcastLanes(s_c);
+    const __m256i v_a2 = broadcastLanes(v_a), v_b2 = broadcastLanes(v_b), v_c2 = broadcastLanes(v_c);
+
+    const __m256i hue_lo = _mm256_set1_epi8((char) thr.hue_lo);
+    const __m256i hue_hi = _mm256_set1_epi8((char) thr.hue_hi);
+    const __m256i sat_lo = _mm256_set1_epi8((char) thr.sat_lo);
+    const __m256i val_lo = _mm256_set1_epi8((char) thr.val_lo);
+
+    int j = 0;
+    for (; j + 32 <= width; j += 32, hsv += 96) {
+        __m256i a = loadLanes(hsv, hsv + 48);
+        __m256i b = loadLanes(hsv + 16, hsv + 64);
+        __m256i c = loadLanes(hsv + 32, hsv + 80);
+
+        __m256i h = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a, h_a2), _mm256_shuffle_epi8(b, h_b2)), _mm256_shuffle_epi8(c, h_c2));
+        __m256i s = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a, s_a2), _mm256_shuffle_epi8(b, s_b2)), _mm256_shuffle_epi8(c, s_c2));
+        __m256i v = _mm256_or_si256(_mm256_or_si256(_mm256_shuffle_epi8(a, v_a2), _mm256_shuffle_epi8(b, v_b2)), _mm256_shuffle_epi8(c, v_c2));
+
+        __m256i m = _mm256_cmpeq_epi8(_mm256_max_epu8(h, hue_lo), h);
+        m = _mm256_and_si256(m, _mm256_cmpeq_epi8(_mm256_max_epu8(s, sat_lo), s));
+        m = _mm256_and_si256(m, _mm256_cmpeq_epi8(_mm256_max_epu8(v, val_lo), v));
+        m = _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_max_epu8(h, hue_hi), h), m);
+
+        _mm256_storeu_si256((__m256i*) (seg + j), m);
+    }
+
+    segmentRowSSE41(hsv, seg + j, width - j, thr);
+}
+
+#undef SHUFFLE_MASKS
+
+static bool hasSSE41()
+{
+    return __builtin_cpu_supports("sse4.1");
+}
+
+static bool hasAVX2()
+{
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+void segmentRowSSE41(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr)
+{
+    segmentRowScalar(hsv, seg, width, thr);
+}
+
+void segmentRowAVX2(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr)
+{
+    segmentRowScalar(hsv, seg, width, thr);
+}
+
+static bool hasSSE41()
+{
+    return false;
+}
+
+static bool hasAVX2()
+{
+    return false;
+}
+
+#endif /* BLUEBALL_X86_KERNELS */
+
+SegmentRowFn selectSegmentKernel(const std::string& name, std::string& selected)
+{
+    if (name != "scalar" && name != "sse4" && hasAVX2()) {
+        selected = "avx2";
+        return segmentRowAVX2;
+    }
+    if (name != "scalar" && hasSSE41()) {
+        selected = "sse4";
+        return segmentRowSSE41;
+    }
+    selected = "scalar";
+    return segmentRowScalar;
+}
+
+}//: namespace Blueball
+}//: namespace Types
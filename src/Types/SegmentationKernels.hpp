@@ -0,0 +1,65 @@
+/*!
+ * \file SegmentationKernels.hpp
+ * \brief Row kernels thresholding interleaved HSV pixels into a binary mask.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef SEGMENTATION_KERNELS_HPP_
+#define SEGMENTATION_KERNELS_HPP_
+
+#include <string>
+
+namespace Types {
+namespace Blueball {
+
+typedef unsigned char uchar;
+
+/*!
+ * \struct HSVThresholds
+ * \brief Thresholds of the HSV box, already in OpenCV 8-bit units.
+ *
+ * Pixel is labeled as foreground (255) when
+ * hue_lo <= hue < hue_hi, sat >= sat_lo and val >= val_lo.
+ */
+struct HSVThresholds
+{
+    uchar hue_lo;
+    uchar hue_hi;
+    uchar sat_lo;
+    uchar val_lo;
+};
+
+/*!
+ * Builds thresholds from integer values, clamping them to 0..255.
+ * Clamping is a no-op for values inside LUT property ranges.
+ */
+HSVThresholds makeThresholds(int hue_lo, int hue_hi, int sat_lo, int val_lo);
+
+/*!
+ * Signature of a row kernel - thresholds \p width interleaved HSV pixels
+ * from \p hsv and writes 0/255 labels to \p seg.
+ */
+typedef void (*SegmentRowFn)(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr);
+
+/// Reference kernel, one pixel per iteration.
+void segmentRowScalar(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr);
+
+/// 16 pixels per iteration, requires SSE4.1.
+void segmentRowSSE41(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr);
+
+/// 32 pixels per iteration, requires AVX2.
+void segmentRowAVX2(const uchar* hsv, uchar* seg, int width, const HSVThresholds& thr);
+
+/*!
+ * Returns kernel with given name ("scalar", "sse4", "avx2" or "auto").
+ * Kernels not supported by the CPU fall back to the best supported one,
+ * "auto" picks the best supported kernel. Name of the kernel that was
+ * actually selected is stored in \p selected.
+ */
+SegmentRowFn selectSegmentKernel(const std::string& name, std::string& selected);
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* SEGMENTATION_KERNELS_HPP_ */
@@ -0,0 +1,94 @@
+/*!
+ * \file SharedPool.hpp
+ * \brief Pool of shared objects recycled between frames.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef SHARED_POOL_HPP_
+#define SHARED_POOL_HPP_
+
+#include <algorithm>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class SharedPool
+ * \brief Ring of shared objects, reused only when nobody else holds them.
+ *
+ * Counterpart of MatPool for containers passed through data streams by
+ * pointer. Object returned by get() is not referenced outside the pool
+ * and keeps its previous contents (and capacity), so refilling it in the
+ * steady state does not allocate. When all objects are still in use, the
+ * oldest one is left to its readers and replaced by a new one.
+ */
+template <typename T>
+class SharedPool
+{
+public:
+    typedef boost::shared_ptr<T> Pointer;
+
+    SharedPool(int capacity = 3) :
+        m_capacity(std::max(1, capacity)), m_next(0)
+    {
+    }
+
+    /// Changes number of objects kept by the pool (at least 1).
+    void setCapacity(int capacity)
+    {
+        capacity = std::max(1, capacity);
+        if (capacity == m_capacity)
+            return;
+
+        m_capacity = capacity;
+        if ((int) m_items.size() > m_capacity)
+            m_items.resize(m_capacity);
+        m_next = 0;
+    }
+
+    /// Returns object free to be overwritten.
+    Pointer get()
+    {
+        for (int i = 0; i < (int) m_items.size(); ++i) {
+            int slot = (m_next + i) % m_items.size();
+            if (m_items[slot].unique()) {
+                m_next = (slot + 1) % m_capacity;
+                return m_items[slot];
+            }
+        }
+
+        if ((int) m_items.size() < m_capacity) {
+            m_items.push_back(Pointer(new T()));
+            m_next = m_items.size() % m_capacity;
+            return m_items.back();
+        }
+
+        // every object is still read downstream - leave the oldest one
+        // to its readers and create a new one in its place
+        int slot = m_next;
+        m_items[slot] = Pointer(new T());
+        m_next = (slot + 1) % m_capacity;
+        return m_items[slot];
+    }
+
+    /// Drops all objects.
+    void clear()
+    {
+        m_items.clear();
+        m_next = 0;
+    }
+
+private:
+    std::vector<Pointer> m_items;
+    int m_capacity;
+    int m_next;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* SHARED_POOL_HPP_ */
@@ -0,0 +1,63 @@
+/*!
+ * \file SlidingWindow.cpp
+ * \brief Last N values with constant-time maximum.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#include <algorithm>
+
+#include "SlidingWindow.hpp"
+
+namespace Types {
+namespace Blueball {
+
+SlidingWindow::SlidingWindow(int capacity)
+{
+    setCapacity(capacity);
+}
+
+void SlidingWindow::setCapacity(int capacity)
+{
+    capacity = std::max(1, capacity);
+    m_values.assign(capacity, 0);
+    m_max_indices.assign(capacity, 0);
+    m_max_values.assign(capacity, 0);
+    clear();
+}
+
+void SlidingWindow::clear()
+{
+    m_size = 0;
+    m_count = 0;
+    m_head = 0;
+    m_length = 0;
+}
+
+void SlidingWindow::push(double value)
+{
+    int capacity = m_values.size();
+
+    m_values[m_count % capacity] = value;
+    m_size = std::min(m_size + 1, capacity);
+
+    // drop the front when it leaves the window
+    if (m_length > 0 && m_max_indices[m_head] <= m_count - capacity) {
+        m_head = (m_head + 1) % capacity;
+        --m_length;
+    }
+
+    // values not greater than the new one will never be the maximum again
+    while (m_length > 0 && m_max_values[(m_head + m_length - 1) % capacity] <= value)
+        --m_length;
+
+    int tail = (m_head + m_length) % capacity;
+    m_max_indices[tail] = m_count;
+    m_max_values[tail] = value;
+    ++m_length;
+
+    ++m_count;
+}
+
+}//: namespace Blueball
+}//: namespace Types
@@ -0,0 +1,84 @@
+/*!
+ * \file SlidingWindow.hpp
+ * \brief Last N values with constant-time maximum.
+ * \author qiubix
+ * \date 2026-10-17
+ */
+
+#ifndef SLIDING_WINDOW_HPP_
+#define SLIDING_WINDOW_HPP_
+
+#include <vector>
+
+namespace Types {
+namespace Blueball {
+
+/*!
+ * \class SlidingWindow
+ * \brief Fixed-capacity history of values with running maximum.
+ *
+ * Values are kept in a ring buffer, maximum in a monotonic deque (also a
+ * ring buffer) of values which may still become the maximum, so push()
+ * is amortized O(1) and never allocates once capacity is set.
+ */
+class SlidingWindow
+{
+public:
+    explicit SlidingWindow(int capacity = 1);
+
+    /// Changes capacity, forgets all values.
+    void setCapacity(int capacity);
+
+    int capacity() const
+    {
+        return m_values.size();
+    }
+
+    /// Forgets all values.
+    void clear();
+
+    /// Appends value, dropping the oldest one when the window is full.
+    void push(double value);
+
+    /// Number of values in the window.
+    int size() const
+    {
+        return m_size;
+    }
+
+    bool empty() const
+    {
+        return m_size == 0;
+    }
+
+    /// The most recent value, window must not be empty.
+    double back() const
+    {
+        return m_values[(m_count - 1) % m_values.size()];
+    }
+
+    /// Maximum of values in the window, window must not be empty.
+    double max() const
+    {
+        return m_max_values[m_head];
+    }
+
+private:
+    /// Values, the i-th pushed one at i % capacity.
+    std::vector<double> m_values;
+    int m_size;
+
+    /// Number of values pushed since clear().
+    long long m_count;
+
+    /// Deque of (index, value) with decreasing values, from m_head, m_length elements.
+    std::vector<long long> m_max_indices;
+    std::vector<double> m_max_values;
+    int m_head;
+    int m_length;
+};
+
+}//: namespace Blueball
+}//: namespace Types
+
+#endif /* SLIDING_WINDOW_HPP_ */